@@ -0,0 +1,482 @@
+/* This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SHM_IPC_CORO_HPP
+#define SHM_IPC_CORO_HPP
+
+/*---------------------------------------------------------- Standard Headers */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <vector>
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------- Project Headers */
+
+#include "shm_ipc_lib.h"
+#include "shm_notify.h"
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------- Defines */
+
+#define SHM_CORO_SPIN        1000  /* Idle polls before parking the executor */
+#define SHM_CORO_PARK_MIN_US 16    /* First park while legacy channels wait, */
+#define SHM_CORO_PARK_US     1000  /* doubled up to this one, see channel    */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------ Data structure */
+
+namespace shm_ipc
+{
+
+class executor;
+
+/* Coroutine started by executor::spawn, it runs detached until it returns */
+struct task
+{
+  struct promise_type
+  {
+    task get_return_object ()
+    {
+      return task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend () noexcept { return {}; }
+    std::suspend_never  final_suspend   () noexcept { return {}; }
+    void return_void         () noexcept {}
+    void unhandled_exception () noexcept { std::terminate(); }
+  };
+
+  explicit task (std::coroutine_handle<promise_type> h) : handle(h) {}
+  task (task &&other) noexcept : handle(other.handle) { other.handle = {}; }
+  task (const task &) = delete;
+  ~task () { if(handle) handle.destroy(); }
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+/* A suspended coroutine and what it is waiting for */
+struct waiter
+{
+  std::coroutine_handle<> handle;
+  struct mymsgbuf         *msg = nullptr;  /* channel::receive only          */
+  unsigned int            gen  = 0;        /* segment::wait_for_update only  */
+  int                     err  = 0;
+};
+
+/* Something coroutines wait on, polled by the executor */
+class source
+{
+public:
+  source (const source &) = delete;
+  source &operator= (const source &) = delete;
+  virtual ~source ();
+
+protected:
+  friend class executor;
+
+  source (executor &exec, key_t key);
+
+  void         suspend (waiter &w, std::coroutine_handle<> h);
+  void         resume  (waiter &w, int err);
+  bool         blind   () const { return legacy_ || !shm_notify_ready(); }
+  virtual bool poll    (bool force) = 0;
+
+  executor            &exec_;
+  key_t               key_;
+  unsigned int        gen_    = 0;
+  bool                dirty_  = true;   /* Read even if the gen did not move */
+  bool                legacy_ = false;  /* Written without post, see channel */
+  std::deque<waiter*> waiters_;
+};
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------- Executor  */
+
+/* Single threaded executor. It polls the channels and segments that have
+   waiters, a generation read from the notify page telling which ones need a
+   system call, and parks on the wake words of their keys once nothing moved
+   for a while. The park has no timeout unless legacy channels wait, or there
+   is no notify page: those are then read after each park, the park doubling
+   from SHM_CORO_PARK_MIN_US up to park_us while nothing comes. The executor
+   is not thread safe, except stop which may be called from any thread */
+class executor
+{
+public:
+  explicit executor (unsigned int spin = SHM_CORO_SPIN,
+                     unsigned int park_us = SHM_CORO_PARK_US)
+    : spin_(spin),
+      park_us_(std::max(park_us, (unsigned int)SHM_CORO_PARK_MIN_US)),
+      wake_((key_t)((std::uintptr_t)this >> 6)) {}
+  executor (const executor &) = delete;
+  executor &operator= (const executor &) = delete;
+  ~executor ();
+
+  void spawn (task t);
+  int  run   ();
+  void stop  ();
+
+private:
+  friend class source;
+
+  std::deque<std::coroutine_handle<>> ready_;
+  std::vector<source*>                sources_;
+  std::size_t                         waiting_ = 0;
+  unsigned int                        spin_;
+  unsigned int                        park_us_;
+  key_t                               wake_;  /* Posted by stop            */
+  std::vector<key_t>                  keys_;  /* Wait set of the park      */
+  std::vector<unsigned int>           seqs_;
+  std::atomic<bool>                   stopped_{false};
+};
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------ Channel  */
+
+/* Messages of one type of an IPC, see read_message */
+class channel : public source
+{
+public:
+  class receive_op
+  {
+  public:
+    receive_op (channel &ch, struct mymsgbuf &msg) : ch_(ch) { w_.msg = &msg; }
+
+    bool await_ready ()
+    {
+      unsigned int gen = shm_notify_gen(ch_.key_);
+      int ret = 0;
+
+      /* Fast path, only enter the kernel if the IPC may hold a message */
+      if(!ch_.waiters_.empty() ||
+         (!ch_.dirty_ && gen == ch_.gen_ && !ch_.blind()))
+      {
+        return false;
+      }
+      if((ret = read_message(ch_.key_, w_.msg, ch_.type_)) == 0)
+      {
+        ch_.gen_   = gen;
+        ch_.dirty_ = false;
+        return false;
+      }
+
+      /* More messages may follow the one just read */
+      ch_.dirty_ = true;
+      w_.err     = (ret < 0) ? errno : 0;
+      return true;
+    }
+    void await_suspend (std::coroutine_handle<> h) { ch_.suspend(w_, h); }
+    int  await_resume  () { return (w_.err != 0) ? (errno = w_.err, -1) : 0; }
+
+  private:
+    channel &ch_;
+    waiter  w_;
+  };
+
+  /* legacy is for an IPC also written by processes not using this library,
+     they do not post so the channel is read after each park of the executor */
+  channel (executor &exec, key_t key, long type = 0, bool legacy = false)
+    : source(exec, key), type_(type) { legacy_ = legacy; }
+
+  /* co_await ch.receive(msg), 0 once msg is filled or -1 and errno */
+  receive_op receive (struct mymsgbuf &msg) { return receive_op(*this, msg); }
+
+  int send (long type, char *text) { return write_message(key_, type, text); }
+
+private:
+  bool poll (bool force) override;
+
+  long type_;
+};
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------ Segment  */
+
+/* Shared memory made by shm_creat, see shm_read and shm_write */
+class segment : public source
+{
+public:
+  class update_op
+  {
+  public:
+    explicit update_op (segment &seg) : seg_(seg) {}
+
+    /* Writes can not be seen without notify page */
+    bool await_ready   ()
+    {
+      if(!shm_notify_ready())
+      {
+        w_.err = ENOTSUP;
+        return true;
+      }
+      return false;
+    }
+    void await_suspend (std::coroutine_handle<> h)
+    {
+      w_.gen = shm_notify_gen(seg_.key_);
+      seg_.suspend(w_, h);
+    }
+    int  await_resume  () { return (w_.err != 0) ? (errno = w_.err, -1) : 0; }
+
+  private:
+    segment &seg_;
+    waiter  w_;
+  };
+
+  segment (executor &exec, key_t key, unsigned int size)
+    : source(exec, key), size_(size) {}
+
+  /* co_await seg.wait_for_update(), resumes after the next shm_write, -1 and
+     ENOTSUP without notify page */
+  update_op wait_for_update () { return update_op(*this); }
+
+  int read  (void *data) { return shm_read(data, size_, key_); }
+  int write (void *data) { return shm_write(data, size_, key_); }
+
+private:
+  bool poll (bool force) override;
+
+  unsigned int size_;
+};
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------- Functions */
+
+inline source::source (executor &exec, key_t key) : exec_(exec), key_(key)
+{
+  exec_.sources_.push_back(this);
+}
+
+/* The coroutines still waiting are resumed with ECANCELED, they must not use
+   this source any more */
+inline source::~source ()
+{
+  auto &v = exec_.sources_;
+
+  while(!waiters_.empty())
+  {
+    resume(*waiters_.front(), ECANCELED);
+    waiters_.pop_front();
+  }
+  v.erase(std::remove(v.begin(), v.end(), this), v.end());
+}
+
+/* Parks a coroutine on this source */
+inline void source::suspend (waiter &w, std::coroutine_handle<> h)
+{
+  w.handle = h;
+  waiters_.push_back(&w);
+  exec_.waiting_++;
+}
+
+/* Hands a waiter back to the executor, it is resumed from run */
+inline void source::resume (waiter &w, int err)
+{
+  w.err = err;
+  exec_.waiting_--;
+  exec_.ready_.push_back(w.handle);
+}
+
+/* Reads messages while there are receivers and the IPC may hold some */
+inline bool channel::poll (bool force)
+{
+  unsigned int gen = shm_notify_gen(key_);
+  bool progress = false;
+  waiter *w;
+  int ret = 0;
+
+  if(!force && !dirty_ && gen == gen_)
+  {
+    return false;
+  }
+  gen_   = gen;
+  dirty_ = false;
+
+  while(!waiters_.empty())
+  {
+    w = waiters_.front();
+
+    if((ret = read_message(key_, w->msg, type_)) == 0)
+    {
+      return progress;
+    }
+
+    waiters_.pop_front();
+    resume(*w, (ret < 0) ? errno : 0);
+    progress = true;
+  }
+
+  /* Receivers ran out first, there may be more messages for the next ones */
+  dirty_ = true;
+
+  return progress;
+}
+
+/* Resumes the waiters that started before the last shm_write */
+inline bool segment::poll (bool)
+{
+  unsigned int gen = shm_notify_gen(key_);
+  bool progress = false;
+
+  /* Waiters are queued in gen order, the first up to date stops the scan */
+  while(!waiters_.empty() && waiters_.front()->gen != gen)
+  {
+    resume(*waiters_.front(), 0);
+    waiters_.pop_front();
+    progress = true;
+  }
+
+  return progress;
+}
+
+/* Destroys the coroutines still suspended */
+inline executor::~executor ()
+{
+  std::vector<std::coroutine_handle<>> frames(ready_.begin(), ready_.end());
+
+  for(source *s : sources_)
+  {
+    for(waiter *w : s->waiters_)
+    {
+      frames.push_back(w->handle);
+    }
+    s->waiters_.clear();
+  }
+  ready_.clear();
+  waiting_ = 0;
+
+  /* A frame may own a source, which then leaves sources_ */
+  for(auto h : frames)
+  {
+    h.destroy();
+  }
+}
+
+/* Queues a task, it starts on the next run */
+inline void executor::spawn (task t)
+{
+  ready_.push_back(t.handle);
+  t.handle = {};
+}
+
+/* Makes run return once the running task suspends, a parked run is woken */
+inline void executor::stop ()
+{
+  stopped_.store(true);
+  shm_notify_post(wake_);
+}
+
+/* Runs the tasks until they are all done or stop is called, a stop done
+   before run makes it return at once. Returns 0, or -1 and errno */
+inline int executor::run ()
+{
+  std::coroutine_handle<> h;
+  unsigned int park = 0;
+  unsigned int idle = 0;
+  bool progress = false;
+  bool blind = false;
+  bool force = false;
+
+  while(!stopped_ && (!ready_.empty() || waiting_ != 0))
+  {
+    while(!stopped_ && !ready_.empty())
+    {
+      h = ready_.front();
+      ready_.pop_front();
+      h.resume();
+    }
+
+    if(stopped_ || waiting_ == 0)
+    {
+      continue;
+    }
+
+    /* Read before polling, a post done while polling cuts the park short */
+    keys_.assign(1, wake_);
+    seqs_.assign(1, shm_notify_seq(wake_));
+    for(source *s : sources_)
+    {
+      if(!s->waiters_.empty())
+      {
+        keys_.push_back(s->key_);
+        seqs_.push_back(shm_notify_seq(s->key_));
+      }
+    }
+    progress = false;
+    blind    = false;
+
+    for(std::size_t i = 0; i < sources_.size(); i++)
+    {
+      source *s = sources_[i];
+
+      if(!s->waiters_.empty())
+      {
+        progress |= s->poll(force && s->blind());
+        blind    |= s->blind();
+      }
+    }
+    force = false;
+
+    if(progress)
+    {
+      idle = 0;
+      park = 0;
+    }
+    else if(++idle >= spin_)
+    {
+      /* Only sources that are not notified need a timeout */
+      if(!blind)
+      {
+        park = 0;
+      }
+      else
+      {
+        park = (park == 0) ? SHM_CORO_PARK_MIN_US
+                           : std::min(park * 2, park_us_);
+      }
+
+      /* A stop done after the read of the wake word posted it */
+      if(stopped_)
+      {
+        break;
+      }
+      if(shm_notify_waitv(keys_.data(), seqs_.data(),
+                          (unsigned int)keys_.size(), park) < 0)
+      {
+        stopped_ = false;
+        return -1;
+      }
+      /* Parks again at once if the wake up brought nothing */
+      idle  = spin_;
+      force = blind;
+    }
+    else
+    {
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_ia32_pause();
+#endif
+    }
+  }
+
+  stopped_ = false;
+
+  return 0;
+}
+
+} /* namespace shm_ipc */
+
+#endif /* SHM_IPC_CORO_HPP */
@@ -11,6 +11,9 @@
    You should have received a copy of the GNU General Public License
    along with this program.  If not, see <https://www.gnu.org/licenses/>. 
 */
+#ifndef SHM_IPC_LIB_H
+#define SHM_IPC_LIB_H
+
 /*---------------------------------------------------------- Standard Headers */
 
 #include <stdio.h>
@@ -45,6 +48,10 @@ struct mymsgbuf
 /*----------------------------------------------------------------------------*/
 /*------------------------------------------------------ Functions prototypes */
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 extern int shm_creat     (unsigned int size, key_t key);
 extern int shm_read      (void *data, unsigned int size, key_t key);
 extern int shm_write     (void *data, unsigned int size, key_t key);
@@ -53,3 +60,9 @@ extern int ipc_creat     (key_t ipc_key);
 extern int read_message  (key_t ipc_key, struct mymsgbuf *qbuf, long type);
 extern int write_message (key_t ipc_key, long type, char *text);
 extern int ipc_destroy   (key_t ipc_key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHM_IPC_LIB_H */
@@ -0,0 +1,158 @@
+/* This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SHM_LOG_H
+#define SHM_LOG_H
+
+/*---------------------------------------------------------- Standard Headers */
+
+#include <sys/types.h>
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------- Project Headers */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------- Defines */
+
+#define SHM_LOG_MAGIC   0x4C4F4731 /* "LOG1" marks an initialized ring       */
+#define SHM_LOG_RECORDS 4096       /* Default ring size, power of 2          */
+
+/* Key of the ring of a process when shm_log_init was not called */
+#define SHM_LOG_KEY(pid) ((key_t)(0x4C000000 | ((pid) & 0x00FFFFFF)))
+
+/* Events of shm_ipc_lib.c */
+#define SHM_EV_SHM_CREAT_SEM        1   /* shm_creat     sem_creat failed    */
+#define SHM_EV_SHM_CREAT_SHMGET     2   /* shm_creat     shmget failed       */
+#define SHM_EV_SHM_READ_LOCK        3   /* shm_read      sem_lock failed     */
+#define SHM_EV_SHM_READ_SHMGET      4   /* shm_read      shmget failed       */
+#define SHM_EV_SHM_READ_SHMAT       5   /* shm_read      shmat failed        */
+#define SHM_EV_SHM_READ_UNLOCK      6   /* shm_read      sem_unlock failed   */
+#define SHM_EV_SHM_WRITE_LOCK       7   /* shm_write     sem_lock failed     */
+#define SHM_EV_SHM_WRITE_SHMGET     8   /* shm_write     shmget failed       */
+#define SHM_EV_SHM_WRITE_SHMAT      9   /* shm_write     shmat failed        */
+#define SHM_EV_SHM_WRITE_UNLOCK     10  /* shm_write     sem_unlock failed   */
+#define SHM_EV_SHM_DESTROY_SEM      11  /* shm_destroy   sem_destroy failed  */
+#define SHM_EV_SHM_DESTROY_SHMGET   12  /* shm_destroy   shmget failed       */
+#define SHM_EV_SHM_DESTROY_RMID     13  /* shm_destroy   IPC_RMID failed     */
+#define SHM_EV_SEM_CREAT_SEMGET     14  /* sem_creat     semget failed       */
+#define SHM_EV_SEM_CREAT_SETVAL     15  /* sem_creat     SETVAL failed       */
+#define SHM_EV_SEM_DESTROY_SEMGET   16  /* sem_destroy   semget failed       */
+#define SHM_EV_SEM_DESTROY_RMID     17  /* sem_destroy   IPC_RMID failed     */
+#define SHM_EV_SEM_LOCK_SEMGET      18  /* sem_lock      semget failed       */
+#define SHM_EV_SEM_LOCK_SEMOP       19  /* sem_lock      semop -1 failed     */
+#define SHM_EV_SEM_UNLOCK_SEMGET    20  /* sem_unlock    semget failed       */
+#define SHM_EV_SEM_UNLOCK_SEMOP     21  /* sem_unlock    semop +1 failed     */
+#define SHM_EV_IPC_CREAT_MSGGET     22  /* ipc_creat     msgget failed       */
+#define SHM_EV_READ_MSG_MSGGET      23  /* read_message  msgget failed       */
+#define SHM_EV_READ_MSG_MSGRCV      24  /* read_message  msgrcv failed       */
+#define SHM_EV_WRITE_MSG_MSGGET     25  /* write_message msgget failed       */
+#define SHM_EV_WRITE_MSG_MSGSND     26  /* write_message msgsnd failed       */
+#define SHM_EV_IPC_DESTROY_MSGGET   27  /* ipc_destroy   msgget failed       */
+#define SHM_EV_IPC_DESTROY_RMID     28  /* ipc_destroy   IPC_RMID failed     */
+
+/* Events of shm_rpc.c */
+#define SHM_EV_RPC_CREAT_GEOMETRY   40  /* shm_rpc_creat   bad geometry      */
+#define SHM_EV_RPC_CREAT_SHMGET     41  /* shm_rpc_creat   shmget failed     */
+#define SHM_EV_RPC_CREAT_SHMAT      42  /* shm_rpc_creat   shmat failed      */
+#define SHM_EV_RPC_DESTROY_SHMGET   43  /* shm_rpc_destroy shmget failed     */
+#define SHM_EV_RPC_DESTROY_RMID     44  /* shm_rpc_destroy IPC_RMID failed   */
+#define SHM_EV_RPC_ATTACH_SHMGET    45  /* shm_rpc_attach  shmget failed     */
+#define SHM_EV_RPC_ATTACH_SHMAT     46  /* shm_rpc_attach  shmat failed      */
+#define SHM_EV_RPC_ATTACH_MAGIC     47  /* shm_rpc_attach  not a RPC segment */
+#define SHM_EV_RPC_DETACH_SHMDT     48  /* shm_rpc_detach  shmdt failed      */
+#define SHM_EV_RPC_SUBMIT_SIZE      49  /* shm_rpc_submit  too big, arg size */
+#define SHM_EV_RPC_WAIT_CALL        50  /* shm_rpc_wait    bad call, arg id  */
+#define SHM_EV_RPC_WAIT_FUTEX       51  /* shm_rpc_wait    futex failed      */
+#define SHM_EV_RPC_SERVE_WORKERS    52  /* shm_rpc_serve   bad count, arg n  */
+#define SHM_EV_RPC_SERVE_THREAD     53  /* shm_rpc_serve   pthread_create    */
+#define SHM_EV_RPC_STOP_FUTEX       54  /* shm_rpc_stop    futex failed      */
+#define SHM_EV_RPC_CREAT_EXISTS     55  /* shm_rpc_creat   key used already  */
+#define SHM_EV_RPC_SERVE_REAP       56  /* shm_rpc_serve   dead calls, arg n */
+
+/* Events of shm_manifest.c */
+#define SHM_EV_MAN_OPEN             60  /* shm_manifest_load  fopen failed   */
+#define SHM_EV_MAN_PARSE            61  /* shm_manifest_load  bad line, arg  */
+#define SHM_EV_MAN_SHMGET           62  /* shm entry       shmget failed     */
+#define SHM_EV_MAN_SIZE             63  /* shm entry       smaller, arg size */
+#define SHM_EV_MAN_SEM              64  /* shm entry       semaphore failed  */
+#define SHM_EV_MAN_SHMAT            65  /* shm entry       shmat failed      */
+#define SHM_EV_MAN_MBIND            66  /* shm entry       mbind, arg node   */
+#define SHM_EV_MAN_PREFAULT         67  /* shm entry       madvise failed    */
+#define SHM_EV_MAN_MSGGET           68  /* ipc entry       msgget failed     */
+#define SHM_EV_MAN_QBYTES           69  /* ipc entry       IPC_SET, arg size */
+#define SHM_EV_MAN_THREAD           70  /* bulk operation  pthread_create    */
+#define SHM_EV_MAN_DESTROY          71  /* bulk teardown   destroy failed    */
+#define SHM_EV_MAN_PAGE             72  /* shm entry       page, arg kB      */
+
+/* Events of shm_notify.c */
+#define SHM_EV_NOTIFY_ATTACH        80  /* notify page     shmget or shmat   */
+#define SHM_EV_NOTIFY_WAIT          81  /* shm_notify_wait futex failed      */
+#define SHM_EV_NOTIFY_MAGIC         82  /* notify page     key used already  */
+
+/* Debug events, only recorded when the library is built with DEBUG */
+#define SHM_EV_DBG_SHM_CREATED      100 /* Shared memory created            */
+#define SHM_EV_DBG_SHM_MAPPED       101 /* Shared memory mapped, arg shmid  */
+#define SHM_EV_DBG_SHM_NATTCH       102 /* Before destroy, arg shm_nattch   */
+#define SHM_EV_DBG_SEM_CREATED      103 /* Semaphore of a shm created       */
+#define SHM_EV_DBG_SEM_LOCKED       104 /* sem_lock done                    */
+#define SHM_EV_DBG_SEM_UNLOCKED     105 /* sem_unlock done                  */
+#define SHM_EV_DBG_RPC_CREATED      106 /* RPC segment created, arg slots   */
+#define SHM_EV_DBG_RPC_STOPPED      107 /* RPC worker stopped, arg 1st slot */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------ Data structure */
+
+/* One event, written in place in the ring */
+struct shm_log_rec
+{
+  unsigned long long seq;    /* Index + 1 once the record is complete        */
+  unsigned long long tsc;    /* Time stamp counter when recorded             */
+  unsigned short     event;  /* SHM_EV_xxx                                   */
+  unsigned short     pad;
+  int                err;    /* errno when recorded                          */
+  int                key;    /* IPC key concerned                            */
+  int                arg;    /* Event specific                               */
+};
+
+/* Ring header, followed by the records */
+struct shm_log_hdr
+{
+  unsigned int       magic;
+  unsigned int       records;  /* Ring size, power of 2                      */
+  int                pid;      /* Process writing the ring                   */
+  unsigned int       tsc_ns;   /* 1 if tsc counts nanoseconds (no TSC)       */
+  unsigned long long tsc0;     /* tsc at init ...                            */
+  unsigned long long ns0;      /* ... and CLOCK_REALTIME at the same time    */
+  unsigned long long head __attribute__((aligned(64))); /* Next index        */
+} __attribute__((aligned(64)));
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------ Functions prototypes */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern int        shm_log_init       (key_t key, unsigned int records);
+extern void       shm_log_event      (unsigned short event, int err, key_t key,
+                                      int arg);
+extern int        shm_log_close      (void);
+extern void       shm_log_keep       (int keep);
+extern int        shm_log_sweep      (void);
+extern const char *shm_log_event_name (unsigned short event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHM_LOG_H */
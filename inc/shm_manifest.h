@@ -0,0 +1,80 @@
+/* This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SHM_MANIFEST_H
+#define SHM_MANIFEST_H
+
+/*---------------------------------------------------------- Standard Headers */
+
+#include <sys/types.h>
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------- Project Headers */
+
+#include "shm_ipc_lib.h"
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------- Defines */
+
+#define SHM_MAN_SHM       1   /* Shared memory and its semaphore (shm_creat) */
+#define SHM_MAN_IPC       2   /* Message queue (ipc_creat)                   */
+
+#define SHM_MAN_NAME      32  /* Max length of an entry name                 */
+#define SHM_MAN_LINE      256 /* Max length of a manifest line               */
+#define SHM_MAN_THREADS   64  /* Max threads of a bulk operation             */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------ Data structure */
+
+/* One line of a manifest */
+struct shm_man_entry
+{
+  int          kind;     /* SHM_MAN_SHM or SHM_MAN_IPC                      */
+  key_t        key;
+  unsigned int size;     /* Segment size, or queue size in byte, 0 default  */
+  unsigned int page;     /* Page size in byte, 0 for the system page        */
+  int          node;     /* NUMA node of the segment, -1 for any            */
+  int          line;     /* Line in the manifest file                       */
+  int          created;  /* Set by shm_manifest_creat if it did not exist   */
+  int          status;   /* 0 or errno of the last bulk operation           */
+  char         name[SHM_MAN_NAME];
+};
+
+/* Loaded manifest */
+struct shm_manifest
+{
+  unsigned int         count;
+  unsigned int         max;
+  unsigned int         line;  /* Bad line found by shm_manifest_load, or 0  */
+  struct shm_man_entry *entry;
+};
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------ Functions prototypes */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern int  shm_manifest_load    (struct shm_manifest *man, const char *path);
+extern void shm_manifest_free    (struct shm_manifest *man);
+extern int  shm_manifest_creat   (struct shm_manifest *man,
+                                  unsigned int threads);
+extern int  shm_manifest_destroy (struct shm_manifest *man,
+                                  unsigned int threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHM_MANIFEST_H */
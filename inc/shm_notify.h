@@ -0,0 +1,58 @@
+/* This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SHM_NOTIFY_H
+#define SHM_NOTIFY_H
+
+/*---------------------------------------------------------- Standard Headers */
+
+#include <sys/types.h>
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------- Project Headers */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------- Defines */
+
+#define SHM_NOTIFY_KEY   ((key_t)0x4E4F5449) /* "NOTI", shared by all users  */
+#define SHM_NOTIFY_OFF   ((key_t)-1)         /* shm_notify_init, no page     */
+#define SHM_NOTIFY_MAGIC 0x4E544632          /* "NTF2" marks the page        */
+#define SHM_NOTIFY_SLOTS 4096                /* Generation counters, power 2 */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------ Data structure */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------ Functions prototypes */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern int          shm_notify_init  (key_t key);
+extern int          shm_notify_ready (void);
+extern int          shm_notify_post  (key_t key);
+extern unsigned int shm_notify_gen   (key_t key);
+extern unsigned int shm_notify_seq   (key_t key);
+extern int          shm_notify_wait  (key_t key, unsigned int seq,
+                                      unsigned int timeout_us);
+extern int          shm_notify_waitv (const key_t *keys,
+                                      const unsigned int *seqs,
+                                      unsigned int n,
+                                      unsigned int timeout_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHM_NOTIFY_H */
@@ -0,0 +1,84 @@
+/* This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef SHM_RPC_H
+#define SHM_RPC_H
+
+/*---------------------------------------------------------- Standard Headers */
+
+#include <sys/types.h>
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------- Project Headers */
+
+#include "shm_ipc_lib.h"
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------- Defines */
+
+#define SHM_RPC_MAX_SLOTS 4096 /* Max outstanding calls on one RPC segment */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------ Data structure */
+
+/* Handle on an attached RPC segment */
+struct shm_rpc
+{
+  key_t key;
+  int   shmid;
+  void  *base;
+};
+
+/* Outstanding call, returned by shm_rpc_submit */
+struct shm_rpc_call
+{
+  unsigned int slot;
+  unsigned int id;    /* Correlation id of the request */
+};
+
+/* Server side handler. The request is in buf, the reply is written in place */
+typedef int (*shm_rpc_handler)(void *arg, void *buf, unsigned int size,
+                               unsigned int max);
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------ Functions prototypes */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern int shm_rpc_creat     (key_t key, unsigned int slots,
+                              unsigned int slot_size);
+extern int shm_rpc_destroy   (key_t key);
+extern int shm_rpc_attach    (struct shm_rpc *rpc, key_t key);
+extern int shm_rpc_detach    (struct shm_rpc *rpc);
+extern int shm_rpc_submit    (struct shm_rpc *rpc, void *data,
+                              unsigned int size, struct shm_rpc_call *call);
+extern int shm_rpc_poll      (struct shm_rpc *rpc, struct shm_rpc_call *call);
+extern int shm_rpc_wait      (struct shm_rpc *rpc, struct shm_rpc_call *call,
+                              void *data, unsigned int *size);
+extern int shm_rpc_timedwait (struct shm_rpc *rpc, struct shm_rpc_call *call,
+                              void *data, unsigned int *size,
+                              unsigned int timeout_ms);
+extern int shm_rpc_cancel    (struct shm_rpc *rpc, struct shm_rpc_call *call);
+extern int shm_rpc_call      (struct shm_rpc *rpc, void *req, unsigned int size,
+                              void *rep, unsigned int *rep_size);
+extern int shm_rpc_serve     (struct shm_rpc *rpc, unsigned int workers,
+                              shm_rpc_handler handler, void *arg);
+extern int shm_rpc_stop      (struct shm_rpc *rpc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHM_RPC_H */
@@ -14,6 +14,8 @@
 /*----------------------------------------------------------- Project Headers */
 
 #include "shm_ipc_lib.h"
+#include "shm_log.h"
+#include "shm_notify.h"
 
 /*----------------------------------------------------------------------------*/
 /*------------------------------------------------------------------- Defines */
@@ -55,29 +57,26 @@ extern int shm_creat (unsigned int size, key_t key)
 
   if( (ret = sem_creat(key + 1)) < 0 )
   {
-    printf("<shm_create> Can not creat a semaphore for shm\n");
-    printf("<shm_create> errno %d\n", errno);
+    shm_log_event(SHM_EV_SHM_CREAT_SEM, errno, key, 0);
     return -1;
   }
 #ifdef DEBUG
   else
   {
-    printf("<shm_create> Got semaphore\n");
+    shm_log_event(SHM_EV_DBG_SEM_CREATED, 0, key, 0);
   }
 #endif
 
   if((shmid = shmget(key, size, IPC_CREAT | 0666)) < 0)
   {
-    printf("<shm_create> Can not create shared memory\n");
-    printf("<shm_create> destroying semaphore\n");
-    printf("<shm_create> errno %d\n", errno);
+    shm_log_event(SHM_EV_SHM_CREAT_SHMGET, errno, key, (int)size);
     sem_destroy(0);
     return -1;
   }
 #ifdef DEBUG
   else
   {
-    printf("<shm_create> OK share memory created\n");
+    shm_log_event(SHM_EV_DBG_SHM_CREATED, 0, key, shmid);
   }
 #endif
 
@@ -103,39 +102,31 @@ extern int shm_read (void *data, unsigned int size, key_t key)
 
   if((sem_lock(key+1)) < 0)
   {
-    printf("<shm_read_conf> Can not take control over shared memory\n");
+    shm_log_event(SHM_EV_SHM_READ_LOCK, errno, key, 0);
     return -1;
   }
 
   if((shmid = shmget(key, size, 0666)) < 0)  /* Request shared memory */
   {
-    printf("<shm_read_conf> Can not get shared memory\n");
-    printf("<shm_read_conf> destroying semaphore\n");
-    printf("<shm_read_conf> errno %d\n", errno);
+    shm_log_event(SHM_EV_SHM_READ_SHMGET, errno, key, (int)size);
     sem_destroy(key + 1);
     return -1;
   }
 
-#ifdef DEBUG
-  printf("<shm_read> shmid %d\n", shmid);
-#endif
-
   if((ptr = shmat(shmid, NULL, 0)) == NULL)  /* Map shared memory */
   {
-    printf("<shm_read_conf> Can not map pointer to shared memory\n");
-    printf("<shm_read_conf> destroying semaphore & shared memory\n");
-    printf("<shm_read_conf> errno %d\n", errno);
+    shm_log_event(SHM_EV_SHM_READ_SHMAT, errno, key, shmid);
 
     if((sem_unlock(key + 1)) < 0)
     {
-      printf("<shm_read_conf> Can not release the semaphore\n");
+      shm_log_event(SHM_EV_SHM_READ_UNLOCK, errno, key, 0);
     }
     return -1;
   }
 #ifdef DEBUG
   else
   {
-    printf("<shm_read_conf> OK share memory mapped\n");
+    shm_log_event(SHM_EV_DBG_SHM_MAPPED, 0, key, shmid);
   }
 #endif
 
@@ -145,7 +136,7 @@ extern int shm_read (void *data, unsigned int size, key_t key)
 
   if((sem_unlock(key + 1)) < 0)
   {
-    printf("<shm_read_conf> Can not release the semaphore\n");
+    shm_log_event(SHM_EV_SHM_READ_UNLOCK, errno, key, 0);
     return -1;
   }
 
@@ -172,39 +163,31 @@ extern int shm_write (void *data, unsigned int size, key_t key)
 
   if((sem_lock(key + 1)) < 0)
   {
-    printf("<shm_write_conf> Can not take control over shared memory\n");
+    shm_log_event(SHM_EV_SHM_WRITE_LOCK, errno, key, 0);
     return -1;
   }
 
   if((shmid = shmget(key, size, 0666)) < 0)  /* Request shared memory */
   {
-    printf("<shm_write_conf> Can not create shared memory\n");
-    printf("<shm_write_conf> destroying semaphore\n");
-    printf("<shm_write_conf> errno %d\n", errno);
+    shm_log_event(SHM_EV_SHM_WRITE_SHMGET, errno, key, (int)size);
     sem_destroy(0);
     return -1;
   }
 
-#ifdef DEBUG
-  printf("<shm_write_conf> shm_id %d\n", shmid);
-#endif
-
   if((ptr = shmat(shmid, NULL, 0)) == NULL)  /* Map shared memory */
   {
-    printf("<shm_write_conf> Can not map pointer to shared memory\n");
-    printf("<shm_write_conf> destroying semaphore & shared memory\n");
-    printf("<shm_write_conf> errno %d\n", errno);
+    shm_log_event(SHM_EV_SHM_WRITE_SHMAT, errno, key, shmid);
 
     if((sem_unlock(key + 1)) < 0)
     {
-      printf("<shm_write_conf> Can not release the semaphore\n");
+      shm_log_event(SHM_EV_SHM_WRITE_UNLOCK, errno, key, 0);
     }
     return -1;
   }
 #ifdef DEBUG
   else
   {
-    printf("<shm_write_conf> OK share memory mapped\n");
+    shm_log_event(SHM_EV_DBG_SHM_MAPPED, 0, key, shmid);
   }
 #endif
 
@@ -214,10 +197,12 @@ extern int shm_write (void *data, unsigned int size, key_t key)
 
   if((sem_unlock(key + 1)) < 0)
   {
-    printf("<shm_write_conf> Can not release the semaphore\n");
+    shm_log_event(SHM_EV_SHM_WRITE_UNLOCK, errno, key, 0);
     return -1;
   }
 
+  shm_notify_post(key);     /* Wake up the waiters on this shared memory */
+
   return 0;
 }
 
@@ -242,32 +227,26 @@ extern int shm_destroy (unsigned int size, key_t key)
 
   if((sem_destroy(key + 1)) < 0)
   {
-    printf("<shm_destroy> Semaphore is not destroied\n");
+    shm_log_event(SHM_EV_SHM_DESTROY_SEM, errno, key, 0);
     err = -1;
   }
 
   if((shmid = shmget(key, size, 0666)) < 0)
   {
-    printf("<shm_destroy> Can not get shared memory\n");
-    printf("<shm_destroy> errno %d\n", errno);
+    shm_log_event(SHM_EV_SHM_DESTROY_SHMGET, errno, key, (int)size);
     return -1;
   }
   else
   {
 #ifdef DEBUG
-    if((shmctl(shmid, IPC_STAT, &buffer)) < 0)
+    if((shmctl(shmid, IPC_STAT, &buffer)) == 0)
     {
-      printf("<shm_destroy> Could not get shm stat\n");
-    }
-    else
-    {
-      printf("<shm_destroy> shm_nattch : 0x%04X\n",
-                                             (unsigned int)(buffer.shm_nattch));
+      shm_log_event(SHM_EV_DBG_SHM_NATTCH, 0, key, (int)buffer.shm_nattch);
     }
 #endif
     if((shmctl(shmid, IPC_RMID, 0) < 0))
     {
-      printf("<shm_destroy> Shared memory is not destroied\n");
+      shm_log_event(SHM_EV_SHM_DESTROY_RMID, errno, key, shmid);
       err = -1;
     }
   }
@@ -298,8 +277,7 @@ int sem_creat (key_t sem_key)
 
   if((semid = semget(sem_key, 1, 0666 | IPC_CREAT)) < 0)
   {
-    printf("<sem_creat> Can not get semaphore\n");
-    printf("<sem_creat> errno %d\n", errno);
+    shm_log_event(SHM_EV_SEM_CREAT_SEMGET, errno, sem_key, 0);
     return -1;
   }
 
@@ -307,8 +285,7 @@ int sem_creat (key_t sem_key)
 
   if((semctl(semid, 0, SETVAL, argument)) < 0)
   {
-    printf("<sem_creat> Can not initialize semaphore to %d\n",argument.val);
-    printf("<sem_creat> errno %d\n", errno);
+    shm_log_event(SHM_EV_SEM_CREAT_SETVAL, errno, sem_key, argument.val);
     return -1;
   }
 
@@ -331,15 +308,13 @@ int sem_destroy (key_t sem_key)
 
   if((semid = semget(sem_key, 1, 0666)) < 0)
   {
-    printf("<sem_destroy> Can not get semaphore\n");
-    printf("<sem_destroy> errno %d\n", errno);
+    shm_log_event(SHM_EV_SEM_DESTROY_SEMGET, errno, sem_key, 0);
     return -1;
   }
 
   if((semctl(semid, 0, IPC_RMID, 0)) < 0)
   {
-    printf("<sem_destroy> Can not destroy semaphore\n");
-    printf("<sem_destroy> errno %d\n", errno);
+    shm_log_event(SHM_EV_SEM_DESTROY_RMID, errno, sem_key, semid);
     return -1;
   }
 
@@ -367,22 +342,20 @@ int sem_lock (key_t sem_key)
 
   if((semid = semget(sem_key, 1, 0666)) < 0)
   {
-    printf("<sem_lock> Can not get semaphore\n");
-    printf("<sem_lock> errno %d\n", errno);
+    shm_log_event(SHM_EV_SEM_LOCK_SEMGET, errno, sem_key, 0);
     return -1;
   }
 
   /* Try to get control of the semaphore */
   if((retval = semop(semid, &op, 1)) != 0)
   {
-    printf("<sem_lock> Can not do operation -1 to semaphore\n");
-    printf("<sem_lock> errno %d\n", errno);
+    shm_log_event(SHM_EV_SEM_LOCK_SEMOP, errno, sem_key, semid);
     return -1;
   }
 #ifdef DEBUG
   else
   {
-    printf("<sem_lock> OK got semaphore.\n");
+    shm_log_event(SHM_EV_DBG_SEM_LOCKED, 0, sem_key, semid);
   }
 #endif
 
@@ -410,22 +383,20 @@ int sem_unlock (key_t sem_key)
 
   if((semid = semget(sem_key, 1, 0666)) < 0)
   {
-    printf("<sem_unlock> Can not release semaphore\n");
-    printf("<sem_unlock> errno %d\n", errno);
+    shm_log_event(SHM_EV_SEM_UNLOCK_SEMGET, errno, sem_key, 0);
     return -1;
   }
 
   /* Try to get control of the semaphore */
   if((retval = semop(semid, &op, 1)) != 0)
   {
-    printf("<sem_unlock> Can not do operation +1 to semaphore\n");
-    printf("<sem_unlock> errno %d\n", errno);
+    shm_log_event(SHM_EV_SEM_UNLOCK_SEMOP, errno, sem_key, semid);
     return -1;
   }
 #ifdef DEBUG
   else
   {
-    printf("<sem_unlock> OK semaphore released.\n");
+    shm_log_event(SHM_EV_DBG_SEM_UNLOCKED, 0, sem_key, semid);
   }
 #endif
 
@@ -448,7 +419,7 @@ extern int ipc_creat (key_t ipc_key)
 
   if((qid = msgget(ipc_key, IPC_CREAT | 0666)) == -1)
   {
-    printf("<ipc_creat> Can not create IPC\n");
+    shm_log_event(SHM_EV_IPC_CREAT_MSGGET, errno, ipc_key, 0);
     return -1;
   }
 
@@ -476,7 +447,7 @@ extern int read_message(key_t ipc_key, struct mymsgbuf *qbuf, long type)
 
   if((qid = msgget(ipc_key, 0666 )) == -1)
   {
-    printf("<read_message> Can not get IPC\n");
+    shm_log_event(SHM_EV_READ_MSG_MSGGET, errno, ipc_key, 0);
     return -1;
   }
 
@@ -493,6 +464,7 @@ extern int read_message(key_t ipc_key, struct mymsgbuf *qbuf, long type)
     /* Check if the call of msgrcv returned no error */
     if( ret == -1 && errno != 0 )
     {
+      shm_log_event(SHM_EV_READ_MSG_MSGRCV, errno, ipc_key, qid);
       ret = -1;
     }
     else
@@ -523,7 +495,7 @@ extern int write_message(key_t ipc_key, long type, char *text)
 
   if((qid = msgget(ipc_key, 0666 )) == -1)
   {
-    printf("<write_message> Can not get IPC\n");
+    shm_log_event(SHM_EV_WRITE_MSG_MSGGET, errno, ipc_key, 0);
     return -1;
   }
 
@@ -534,10 +506,12 @@ extern int write_message(key_t ipc_key, long type, char *text)
 
   if((msgsnd(qid, (struct msgbuf *)&qbuf, length, 0)) == -1)
   {
-    printf("<write_message> Error on msgsend\n");
+    shm_log_event(SHM_EV_WRITE_MSG_MSGSND, errno, ipc_key, (int)length);
     return -1;
   }
 
+  shm_notify_post(ipc_key); /* Wake up the readers of this IPC */
+
   return 0;
 }
 
@@ -557,13 +531,13 @@ extern int ipc_destroy (key_t ipc_key)
 
   if((qid = msgget(ipc_key, 0666)) == -1)
   {
-    printf("<ipc_destroy> Can not get IPC\n");
+    shm_log_event(SHM_EV_IPC_DESTROY_MSGGET, errno, ipc_key, 0);
     return -1;
   }
 
   if(msgctl(qid, IPC_RMID, 0) < 0)
   {
-    printf("<ipc_destroy> Can not remove IPC\n");
+    shm_log_event(SHM_EV_IPC_DESTROY_RMID, errno, ipc_key, qid);
     return -1;
   }
 
@@ -612,7 +586,12 @@ extern int ipc_destroy (key_t ipc_key)
 /*!
  *  \fn int shm_write (void *data, unsigned int size, key_t key)
  *  This function writes the contains of data poineter to a shared memory.
- *  Shared memory is selected with the key passed in argument.
+ *  Shared memory is selected with the key passed in argument. The waiters of
+ *  shm_notify_wait are then told the shared memory changed.
+ *  \note Notification is opt-in, nothing is posted until a process creates
+ *  the notify page with shm_notify_init or by waiting, as the coroutine layer
+ *  does. Until then each call only looks for the page. See shm_notify_init
+ *  to use another key or to disable it.
  *  \param data Pointer to the buffer that contains the data to write in the 
  *              shared memory.
  *  \param size Size of the shared memory to write in byte.
@@ -657,7 +636,9 @@ extern int ipc_destroy (key_t ipc_key)
 
 /*!
  *  \fn int write_message (key_t ipc_key, long type, char *text)
- *  This function do the low level send message over the IPC.
+ *  This function do the low level send message over the IPC. The waiters of
+ *  shm_notify_wait are then told a message is available.
+ *  \note Notification is opt-in, as for shm_write.
  *  \param ipc_key  The key to access to the IPC.
  *  \param type     Type of the message to send.
  *  \param text     Pointer to the buffer that contains the data to write to 
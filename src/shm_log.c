@@ -0,0 +1,533 @@
+/* This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*---------------------------------------------------------- Standard Headers */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------- Project Headers */
+
+#include "shm_log.h"
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------- Defines */
+
+/* Ring states */
+#define LOG_NONE    0  /* Not created yet, the first event creates it        */
+#define LOG_BUSY    1  /* Being created, events are dropped                  */
+#define LOG_READY   2
+#define LOG_OFF     3  /* Creation failed or ring closed, events are dropped */
+
+#define EV(x) case SHM_EV_##x: return #x
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------ Data structure */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------- Functions prototype */
+
+/* These functions are for library's internal use */
+static unsigned long long log_tsc    (void);
+static void               log_atfork (void);
+static void               log_child  (void);
+static void               log_exit   (void);
+static int                log_stale  (int shmid);
+
+/*----------------------------------------------------------------------------*/
+/*--------------------------------------------------------------- Global data */
+
+static struct shm_log_hdr *log_hdr = NULL;
+static int                log_shmid = -1;
+static unsigned int       log_state = LOG_NONE;
+static int                log_keep = 0;
+static pthread_once_t     log_once = PTHREAD_ONCE_INIT;
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------- Functions */
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_log_init                                                 *
+* Description   : This function creates the event ring of the process in a     *
+*                 shared memory so that shm_log_tail can read it, even after   *
+*                 the process died. Calling it is optional, the first event    *
+*                 creates the ring with the default key and size. A segment    *
+*                 already holding the key is only replaced if it is the ring   *
+*                 of a dead process.                                           *
+* Argument      : key      The key of the ring, SHM_LOG_KEY(getpid()) if 0.    *
+*                 records  Size of the ring, power of 2, SHM_LOG_RECORDS if 0. *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set.                                *
+\*----------------------------------------------------------------------------*/
+extern int shm_log_init (key_t key, unsigned int records)
+{
+  struct shm_log_hdr *hdr;
+  struct timespec now;
+  unsigned int state = LOG_NONE;
+  size_t size = 0;
+  int shmid = 0;
+
+  if(key == 0)
+  {
+    key = SHM_LOG_KEY(getpid());
+  }
+  if(records == 0)
+  {
+    records = SHM_LOG_RECORDS;
+  }
+  if((records & (records - 1)) != 0)
+  {
+    errno = EINVAL;
+    return -1;
+  }
+
+  if(!__atomic_compare_exchange_n(&log_state, &state, LOG_BUSY, 0,
+                                  __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) &&
+     (state != LOG_OFF ||
+      !__atomic_compare_exchange_n(&log_state, &state, LOG_BUSY, 0,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)))
+  {
+    errno = EBUSY;
+    return -1;
+  }
+
+  pthread_once(&log_once, log_atfork);
+
+  size = sizeof(struct shm_log_hdr) + records * sizeof(struct shm_log_rec);
+
+  /* Only a ring left by a dead process is replaced, any other segment
+     holding the key is left alone */
+  if((shmid = shmget(key, size, IPC_CREAT | IPC_EXCL | 0666)) < 0 &&
+     errno == EEXIST && (shmid = shmget(key, 0, 0666)) >= 0)
+  {
+    if(log_stale(shmid) == 1 && shmctl(shmid, IPC_RMID, 0) == 0)
+    {
+      shmid = shmget(key, size, IPC_CREAT | IPC_EXCL | 0666);
+    }
+    else
+    {
+      shmid = -1;
+      errno = EEXIST;
+    }
+  }
+
+  if(shmid < 0 || (hdr = shmat(shmid, NULL, 0)) == (void *)-1)
+  {
+    __atomic_store_n(&log_state, LOG_OFF, __ATOMIC_RELEASE);
+    return -1;
+  }
+
+  /* The segment is new, hence all zero */
+  clock_gettime(CLOCK_REALTIME, &now);
+  hdr->records = records;
+  hdr->pid     = getpid();
+  hdr->tsc0    = log_tsc();
+  hdr->ns0     = now.tv_sec * 1000000000ULL + now.tv_nsec;
+#if !defined(__x86_64__) && !defined(__i386__)
+  hdr->tsc_ns  = 1;
+#endif
+  __atomic_store_n(&hdr->magic, SHM_LOG_MAGIC, __ATOMIC_RELEASE);
+
+  __atomic_store_n(&log_hdr, hdr, __ATOMIC_RELEASE);
+  log_shmid = shmid;
+  __atomic_store_n(&log_state, LOG_READY, __ATOMIC_RELEASE);
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_log_event                                                *
+* Description   : This function records an event in the ring of the process.  *
+*                 It takes no lock and does no system call once the ring is    *
+*                 created, errno is left untouched.                            *
+* Argument      : event  SHM_EV_xxx.                                           *
+*                 err    errno to record.                                      *
+*                 key    The IPC key concerned.                                *
+*                 arg    Event specific value.                                 *
+* Return code   : None.                                                        *
+\*----------------------------------------------------------------------------*/
+extern void shm_log_event (unsigned short event, int err, key_t key, int arg)
+{
+  struct shm_log_hdr *hdr;
+  struct shm_log_rec *rec;
+  unsigned long long idx = 0;
+  unsigned int state = 0;
+  int saved = errno;
+
+  if((state = __atomic_load_n(&log_state, __ATOMIC_ACQUIRE)) != LOG_READY)
+  {
+    if(state != LOG_NONE || shm_log_init(0, 0) < 0)
+    {
+      errno = saved;
+      return;
+    }
+  }
+
+  hdr = __atomic_load_n(&log_hdr, __ATOMIC_ACQUIRE);
+  idx = __atomic_fetch_add(&hdr->head, 1, __ATOMIC_RELAXED);
+  rec = (struct shm_log_rec *)(hdr + 1) + (idx & (hdr->records - 1));
+
+  /* Same protocol as a seqlock: the reader drops a record whose seq moved */
+  __atomic_store_n(&rec->seq, 0, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  rec->tsc   = log_tsc();
+  rec->event = event;
+  rec->err   = err;
+  rec->key   = (int)key;
+  rec->arg   = arg;
+
+  __atomic_store_n(&rec->seq, idx + 1, __ATOMIC_RELEASE);
+
+  errno = saved;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_log_close                                                *
+* Description   : This function destroys the ring of the process. Next events  *
+*                 are dropped until shm_log_init is called again. The ring     *
+*                 stays mapped, a thread that saw it ready may still write it. *
+* Argument      : None.                                                        *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set.                                *
+\*----------------------------------------------------------------------------*/
+extern int shm_log_close (void)
+{
+  unsigned int state = LOG_READY;
+
+  if(!__atomic_compare_exchange_n(&log_state, &state, LOG_OFF, 0,
+                                  __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+  {
+    errno = EINVAL;
+    return -1;
+  }
+
+  /* Removed once the process exits, shmdt would fault the writers */
+  return shmctl(log_shmid, IPC_RMID, 0);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_log_keep                                                 *
+* Description   : This function tells whether the ring is kept when the        *
+*                 process exits. By default it is destroyed by a normal exit   *
+*                 and only the ring of a crashed process is left behind.       *
+* Argument      : keep  1 to keep the ring after exit, 0 to destroy it.        *
+* Return code   : None.                                                        *
+\*----------------------------------------------------------------------------*/
+extern void shm_log_keep (int keep)
+{
+  __atomic_store_n(&log_keep, keep, __ATOMIC_RELAXED);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_log_sweep                                                *
+* Description   : This function destroys the rings of the dead processes,      *
+*                 whatever their key. Other segments are not touched.          *
+* Argument      : None.                                                        *
+* Return code   : Number of rings destroyed.                                   *
+*                 -1     On error errno is set.                                *
+\*----------------------------------------------------------------------------*/
+extern int shm_log_sweep (void)
+{
+  struct shm_info info;
+  struct shmid_ds ds;
+  int count = 0;
+  int shmid = 0;
+  int max = 0;
+  int i = 0;
+
+  if((max = shmctl(0, SHM_INFO, (struct shmid_ds *)&info)) < 0)
+  {
+    return -1;
+  }
+
+  for(i = 0; i <= max; i++)
+  {
+    if((shmid = shmctl(i, SHM_STAT, &ds)) < 0 || shmid == log_shmid)
+    {
+      continue;
+    }
+    if(log_stale(shmid) == 1 && shmctl(shmid, IPC_RMID, 0) == 0)
+    {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_log_event_name                                           *
+* Description   : This function gives the name of an event.                   *
+* Argument      : event  SHM_EV_xxx.                                           *
+* Return code   : Name of the event, "UNKNOWN" if it is not known.             *
+\*----------------------------------------------------------------------------*/
+extern const char *shm_log_event_name (unsigned short event)
+{
+  switch(event)
+  {
+    EV(SHM_CREAT_SEM);       EV(SHM_CREAT_SHMGET);
+    EV(SHM_READ_LOCK);       EV(SHM_READ_SHMGET);
+    EV(SHM_READ_SHMAT);      EV(SHM_READ_UNLOCK);
+    EV(SHM_WRITE_LOCK);      EV(SHM_WRITE_SHMGET);
+    EV(SHM_WRITE_SHMAT);     EV(SHM_WRITE_UNLOCK);
+    EV(SHM_DESTROY_SEM);     EV(SHM_DESTROY_SHMGET);
+    EV(SHM_DESTROY_RMID);    EV(SEM_CREAT_SEMGET);
+    EV(SEM_CREAT_SETVAL);    EV(SEM_DESTROY_SEMGET);
+    EV(SEM_DESTROY_RMID);    EV(SEM_LOCK_SEMGET);
+    EV(SEM_LOCK_SEMOP);      EV(SEM_UNLOCK_SEMGET);
+    EV(SEM_UNLOCK_SEMOP);    EV(IPC_CREAT_MSGGET);
+    EV(READ_MSG_MSGGET);     EV(READ_MSG_MSGRCV);
+    EV(WRITE_MSG_MSGGET);    EV(WRITE_MSG_MSGSND);
+    EV(IPC_DESTROY_MSGGET);  EV(IPC_DESTROY_RMID);
+    EV(RPC_CREAT_GEOMETRY);  EV(RPC_CREAT_SHMGET);
+    EV(RPC_CREAT_SHMAT);     EV(RPC_DESTROY_SHMGET);
+    EV(RPC_DESTROY_RMID);    EV(RPC_ATTACH_SHMGET);
+    EV(RPC_ATTACH_SHMAT);    EV(RPC_ATTACH_MAGIC);
+    EV(RPC_DETACH_SHMDT);    EV(RPC_SUBMIT_SIZE);
+    EV(RPC_WAIT_CALL);       EV(RPC_WAIT_FUTEX);
+    EV(RPC_SERVE_WORKERS);   EV(RPC_SERVE_THREAD);
+    EV(RPC_STOP_FUTEX);      EV(RPC_CREAT_EXISTS);
+    EV(RPC_SERVE_REAP);
+    EV(MAN_OPEN);            EV(MAN_PARSE);
+    EV(MAN_SHMGET);          EV(MAN_SIZE);
+    EV(MAN_SEM);             EV(MAN_SHMAT);
+    EV(MAN_MBIND);           EV(MAN_PREFAULT);
+    EV(MAN_MSGGET);          EV(MAN_QBYTES);
+    EV(MAN_THREAD);          EV(MAN_DESTROY);
+    EV(MAN_PAGE);
+    EV(NOTIFY_ATTACH);       EV(NOTIFY_WAIT);
+    EV(NOTIFY_MAGIC);
+    EV(DBG_SHM_CREATED);     EV(DBG_SHM_MAPPED);
+    EV(DBG_SHM_NATTCH);      EV(DBG_SEM_CREATED);
+    EV(DBG_SEM_LOCKED);      EV(DBG_SEM_UNLOCKED);
+    EV(DBG_RPC_CREATED);     EV(DBG_RPC_STOPPED);
+  }
+
+  return "UNKNOWN";
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : log_tsc                                                      *
+* Description   : This function reads the time stamp counter. Without TSC the  *
+*                 monotonic clock in nanosecond is used.                       *
+* Argument      : None.                                                        *
+* Return code   : Current tsc.                                                 *
+\*----------------------------------------------------------------------------*/
+static unsigned long long log_tsc (void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : log_atfork                                                   *
+* Description   : This function registers log_child and log_exit, it is called *
+*                 once.                                                        *
+* Argument      : None.                                                        *
+* Return code   : None.                                                        *
+\*----------------------------------------------------------------------------*/
+static void log_atfork (void)
+{
+  pthread_atfork(NULL, NULL, log_child);
+  atexit(log_exit);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : log_child                                                    *
+* Description   : Called in a forked child, it drops the ring of the parent.   *
+*                 The child creates its own ring on its first event.           *
+* Argument      : None.                                                        *
+* Return code   : None.                                                        *
+\*----------------------------------------------------------------------------*/
+static void log_child (void)
+{
+  if(log_hdr != NULL)
+  {
+    shmdt(log_hdr);
+    log_hdr = NULL;
+  }
+  log_shmid = -1;
+  log_state = LOG_NONE;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : log_exit                                                     *
+* Description   : Called on a normal exit, it marks the ring of the process    *
+*                 for removal unless shm_log_keep asked to keep it. Threads    *
+*                 still running keep recording until the process is gone.      *
+* Argument      : None.                                                        *
+* Return code   : None.                                                        *
+\*----------------------------------------------------------------------------*/
+static void log_exit (void)
+{
+  if(!__atomic_load_n(&log_keep, __ATOMIC_RELAXED) &&
+     __atomic_load_n(&log_state, __ATOMIC_ACQUIRE) == LOG_READY)
+  {
+    shmctl(log_shmid, IPC_RMID, 0);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : log_stale                                                    *
+* Description   : This function tells whether a shared memory is the ring of   *
+*                 a dead process. The pid of the caller counts as dead, its    *
+*                 own ring is never looked up this way.                        *
+* Argument      : shmid  The shared memory to check.                           *
+* Return code   : 1      It is a ring and its process is dead.                 *
+*                 0      Anything else, or it can not be read.                 *
+\*----------------------------------------------------------------------------*/
+static int log_stale (int shmid)
+{
+  struct shm_log_hdr *hdr;
+  struct shmid_ds ds;
+  int stale = 0;
+  int saved = errno;
+
+  if(shmctl(shmid, IPC_STAT, &ds) < 0 ||
+     ds.shm_segsz < sizeof(struct shm_log_hdr) ||
+     (hdr = shmat(shmid, NULL, SHM_RDONLY)) == (void *)-1)
+  {
+    errno = saved;
+    return 0;
+  }
+
+  if(__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) == SHM_LOG_MAGIC &&
+     hdr->records != 0 && (hdr->records & (hdr->records - 1)) == 0 &&
+     ds.shm_segsz == sizeof(struct shm_log_hdr) +
+                     hdr->records * sizeof(struct shm_log_rec) &&
+     (hdr->pid == getpid() || (kill(hdr->pid, 0) < 0 && errno == ESRCH)))
+  {
+    stale = 1;
+  }
+
+  shmdt(hdr);
+  errno = saved;
+
+  return stale;
+}
+
+/*---------------------------------------------- Doxygen documentation sectin */
+/*!
+ *  \file shm_log.c
+ *  \brief Lock-free binary event ring of the library
+ *  \author Renaud De Koninck
+ *  \version 1.0
+ *  \date 19 October 2026
+ */
+
+
+
+
+/*!
+ *  \fn int shm_log_init (key_t key, unsigned int records)
+ *  This function creates the event ring of the process in a shared memory so
+ *  that shm_log_tail can decode it, even after the process died. Calling it is
+ *  optional, the first event creates the ring with the default key and size.
+ *  \param key     The key of the ring, SHM_LOG_KEY(getpid()) if 0.
+ *  \param records Number of records of the ring, a power of 2,
+ *                 SHM_LOG_RECORDS if 0.
+ *  A segment already holding the key is only replaced if it is the ring of a
+ *  dead process, any other segment is left alone and the call fails with
+ *  EEXIST. The ring is destroyed by a normal exit, see shm_log_keep.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error, EBUSY if the ring is
+ *	  already created, EEXIST if the key is used by something else.
+ */
+
+/*!
+ *  \fn void shm_log_event (unsigned short event, int err, key_t key, int arg)
+ *  This function records an event in the ring of the process. It takes no
+ *  lock and does no system call once the ring is created, the oldest records
+ *  are overwritten when the ring is full. errno is left untouched.
+ *  \param event SHM_EV_xxx.
+ *  \param err   errno to record.
+ *  \param key   The IPC key concerned.
+ *  \param arg   Event specific value.
+ */
+
+/*!
+ *  \fn int shm_log_close (void)
+ *  This function destroys the ring of the process. Next events are dropped
+ *  until shm_log_init is called again. The ring is not unmapped, a thread
+ *  that was recording an event may still write it, and the kernel frees it
+ *  when the process exits.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error.
+ */
+
+/*!
+ *  \fn void shm_log_keep (int keep)
+ *  This function tells whether the ring is kept when the process exits. By
+ *  default a normal exit destroys it, so that only the rings of crashed
+ *  processes are left for shm_log_tail. Those are destroyed by shm_log_tail -r
+ *  or -s.
+ *  \param keep 1 to keep the ring after exit, 0 to destroy it.
+ */
+
+/*!
+ *  \fn int shm_log_sweep (void)
+ *  This function destroys the rings left by dead processes, whatever their
+ *  key. A segment is only destroyed if it holds SHM_LOG_MAGIC, has the size
+ *  of a ring and its process does not exist anymore.
+ *  \return
+ *	- Number of rings destroyed.
+ *	- -1 On Faillure & errno contains system error.
+ */
+
+/*!
+ *  \fn const char *shm_log_event_name (unsigned short event)
+ *  This function gives the name of an event, as used by shm_log_tail.
+ *  \param event SHM_EV_xxx.
+ *  \return Name of the event, "UNKNOWN" if it is not known.
+ */
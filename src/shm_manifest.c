@@ -0,0 +1,797 @@
+/* This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*---------------------------------------------------------- Standard Headers */
+
+#define _GNU_SOURCE  /* SHM_HUGETLB and MADV_POPULATE_WRITE */
+
+#include <pthread.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------- Project Headers */
+
+#include "shm_manifest.h"
+#include "shm_log.h"
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------- Defines */
+
+#ifndef SHM_HUGE_SHIFT
+#define SHM_HUGE_SHIFT      26
+#endif
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+#define MAN_MAX_NODE 1024  /* Highest NUMA node accepted in a manifest */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------ Data structure */
+
+/* Context shared by the threads of a bulk operation */
+struct man_bulk
+{
+  struct shm_manifest *man;
+  int                 (*fn)(struct shm_man_entry *e);
+  unsigned int        next;    /* Next entry to take                         */
+};
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------- Functions prototype */
+
+/* These functions are for library's internal use */
+int sem_creat   (key_t sem_key);
+int sem_destroy (key_t sem_key);
+
+static int          man_parse    (char *line, struct shm_man_entry *e);
+static int          man_size     (const char *str, unsigned int *size);
+static int          man_run      (struct shm_manifest *man,
+                                  unsigned int threads,
+                                  int (*fn)(struct shm_man_entry *e));
+static void         *man_worker  (void *ctx);
+static int          man_shm_up   (struct shm_man_entry *e);
+static void         man_shm_undo (struct shm_man_entry *e, int shmid, int sem);
+static unsigned int man_page     (void *ptr);
+static int          man_ipc_up   (struct shm_man_entry *e);
+static int          man_down     (struct shm_man_entry *e);
+static int          man_up       (struct shm_man_entry *e);
+
+/*----------------------------------------------------------------------------*/
+/*--------------------------------------------------------------- Global data */
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------- Functions */
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_manifest_load                                            *
+* Description   : This function reads a manifest, one segment or queue a line: *
+*                   shm <key> <size> [page=<size>] [node=<n>] [name=<name>]    *
+*                   ipc <key> [size=<qbytes>] [name=<name>]                    *
+*                 Sizes take a k, m or g suffix, # starts a comment. Lines are *
+*                 at most SHM_MAN_LINE - 2 characters.                         *
+* Argument      : man   Manifest to fill, freed with shm_manifest_free.        *
+*                 path  Path of the manifest file.                             *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set, EINVAL for a bad line whose    *
+*                        number is then in man->line.                          *
+\*----------------------------------------------------------------------------*/
+extern int shm_manifest_load (struct shm_manifest *man, const char *path)
+{
+  FILE *file;
+  char line[SHM_MAN_LINE];
+  struct shm_man_entry *entry;
+  int nb = 0;
+
+  memset(man, 0, sizeof(*man));
+
+  if((file = fopen(path, "r")) == NULL)
+  {
+    shm_log_event(SHM_EV_MAN_OPEN, errno, 0, 0);
+    return -1;
+  }
+
+  while(fgets(line, sizeof(line), file) != NULL)
+  {
+    nb++;
+
+    /* The rest of a long line would be parsed as a line of its own */
+    if(strchr(line, '\n') == NULL && getc(file) != EOF)
+    {
+      shm_log_event(SHM_EV_MAN_PARSE, E2BIG, 0, nb);
+      fclose(file);
+      shm_manifest_free(man);
+      man->line = nb;
+      errno = EINVAL;
+      return -1;
+    }
+
+    if(man->count == man->max)
+    {
+      man->max = (man->max == 0) ? 64 : man->max * 2;
+
+      if((entry = realloc(man->entry, man->max * sizeof(*entry))) == NULL)
+      {
+        fclose(file);
+        shm_manifest_free(man);
+        errno = ENOMEM;
+        return -1;
+      }
+      man->entry = entry;
+    }
+
+    entry = &man->entry[man->count];
+    memset(entry, 0, sizeof(*entry));
+    entry->line = nb;
+    entry->node = -1;
+
+    switch(man_parse(line, entry))
+    {
+      case 1 : man->count++;  break;
+      case 0 :                break;  /* Empty line or comment */
+      default:
+        shm_log_event(SHM_EV_MAN_PARSE, EINVAL, 0, nb);
+        fclose(file);
+        shm_manifest_free(man);
+        man->line = nb;
+        errno = EINVAL;
+        return -1;
+    }
+  }
+
+  fclose(file);
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_manifest_free                                            *
+* Description   : This function frees a manifest loaded by shm_manifest_load.  *
+*                 The segments and queues are not touched.                     *
+* Argument      : man  Manifest to free.                                       *
+* Return code   : None.                                                        *
+\*----------------------------------------------------------------------------*/
+extern void shm_manifest_free (struct shm_manifest *man)
+{
+  free(man->entry);
+  memset(man, 0, sizeof(*man));
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_manifest_creat                                           *
+* Description   : This function creates, or checks if they exist, all the      *
+*                 segments and queues of a manifest in parallel. Segments are  *
+*                 bound to their NUMA node and pre-faulted so that the first   *
+*                 accesses do not allocate pages.                              *
+* Argument      : man      Manifest filled by shm_manifest_load.               *
+*                 threads  Number of threads, one per CPU if 0.                *
+* Return code   : 0      On success.                                           *
+*                 -1     If an entry failed, errno is the one of the first     *
+*                        failed entry and each entry status is set.            *
+\*----------------------------------------------------------------------------*/
+extern int shm_manifest_creat (struct shm_manifest *man, unsigned int threads)
+{
+  return man_run(man, threads, man_up);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_manifest_destroy                                         *
+* Description   : This function destroys all the segments and queues of a      *
+*                 manifest in parallel. An entry that does not exist any more  *
+*                 is not an error.                                             *
+* Argument      : man      Manifest filled by shm_manifest_load.               *
+*                 threads  Number of threads, one per CPU if 0.                *
+* Return code   : 0      On success.                                           *
+*                 -1     If an entry failed, errno is the one of the first     *
+*                        failed entry and each entry status is set.            *
+\*----------------------------------------------------------------------------*/
+extern int shm_manifest_destroy (struct shm_manifest *man, unsigned int threads)
+{
+  return man_run(man, threads, man_down);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : man_parse                                                    *
+* Description   : This function parses one line of a manifest.                 *
+* Argument      : line  Line to parse, it is modified.                         *
+*                 e     Entry to fill.                                         *
+* Return code   : 1      An entry is filled.                                   *
+*                 0      Empty line.                                           *
+*                 -1     Bad line.                                             *
+\*----------------------------------------------------------------------------*/
+static int man_parse (char *line, struct shm_man_entry *e)
+{
+  char *save = NULL;
+  char *tok;
+  char *end;
+  int nb = 0;
+
+  if((end = strchr(line, '#')) != NULL)
+  {
+    *end = '\0';
+  }
+
+  for(tok = strtok_r(line, " \t\r\n", &save); tok != NULL;
+      tok = strtok_r(NULL, " \t\r\n", &save), nb++)
+  {
+    if(nb == 0)
+    {
+      if(strcasecmp(tok, "shm") == 0)      e->kind = SHM_MAN_SHM;
+      else if(strcasecmp(tok, "ipc") == 0) e->kind = SHM_MAN_IPC;
+      else                                 return -1;
+    }
+    else if(nb == 1)
+    {
+      e->key = (key_t)strtoul(tok, &end, 0);
+      if(*end != '\0' || e->key == IPC_PRIVATE) return -1;
+    }
+    else if(strncmp(tok, "page=", 5) == 0)
+    {
+      if(man_size(tok + 5, &e->page) < 0 ||
+         (e->page & (e->page - 1)) != 0 ||
+         e->page < (unsigned int)sysconf(_SC_PAGESIZE)) return -1;
+    }
+    else if(strncmp(tok, "node=", 5) == 0)
+    {
+      e->node = (int)strtol(tok + 5, &end, 0);
+      if(*end != '\0' || e->node < 0 || e->node >= MAN_MAX_NODE) return -1;
+    }
+    else if(strncmp(tok, "name=", 5) == 0)
+    {
+      snprintf(e->name, sizeof(e->name), "%s", tok + 5);
+    }
+    else if(strncmp(tok, "size=", 5) == 0)
+    {
+      if(man_size(tok + 5, &e->size) < 0) return -1;
+    }
+    else if(nb == 2)
+    {
+      if(man_size(tok, &e->size) < 0) return -1;
+    }
+    else
+    {
+      return -1;
+    }
+  }
+
+  if(nb == 0)
+  {
+    return 0;
+  }
+
+  /* A segment needs a size, a queue has no page nor node */
+  if((e->kind == SHM_MAN_SHM && e->size == 0) ||
+     (e->kind == SHM_MAN_IPC && (e->page != 0 || e->node >= 0)))
+  {
+    return -1;
+  }
+
+  return 1;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : man_size                                                     *
+* Description   : This function converts a size with an optional k, m or g     *
+*                 suffix.                                                      *
+* Argument      : str   Size to convert.                                       *
+*                 size  Converted size in byte.                                *
+* Return code   : 0      On success.                                           *
+*                 -1     If str is not a size.                                 *
+\*----------------------------------------------------------------------------*/
+static int man_size (const char *str, unsigned int *size)
+{
+  unsigned long long val = 0;
+  char *end;
+
+  val = strtoull(str, &end, 0);
+
+  switch(*end)
+  {
+    case 'k': case 'K': val <<= 10; end++; break;
+    case 'm': case 'M': val <<= 20; end++; break;
+    case 'g': case 'G': val <<= 30; end++; break;
+  }
+
+  if(end == str || *end != '\0' || val > 0xFFFFFFFFULL)
+  {
+    return -1;
+  }
+
+  *size = (unsigned int)val;
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : man_run                                                      *
+* Description   : This function applies fn to every entry of a manifest from   *
+*                 a pool of threads. The calling thread is part of the pool.   *
+* Argument      : man      Manifest filled by shm_manifest_load.               *
+*                 threads  Number of threads, one per CPU if 0.                *
+*                 fn       Returns 0 or an errno for one entry.                *
+* Return code   : 0      On success.                                           *
+*                 -1     If an entry failed, errno is set.                     *
+\*----------------------------------------------------------------------------*/
+static int man_run (struct shm_manifest *man, unsigned int threads,
+                    int (*fn)(struct shm_man_entry *e))
+{
+  struct man_bulk bulk;
+  pthread_t tid[SHM_MAN_THREADS];
+  unsigned int started = 0;
+  unsigned int i = 0;
+  int err = 0;
+
+  if(threads == 0)
+  {
+    threads = (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+  }
+  if(threads > SHM_MAN_THREADS)
+  {
+    threads = SHM_MAN_THREADS;
+  }
+  if(threads > man->count)
+  {
+    threads = man->count;
+  }
+
+  bulk.man  = man;
+  bulk.fn   = fn;
+  bulk.next = 0;
+
+  for(started = 0; started + 1 < threads; started++)
+  {
+    if((err = pthread_create(&tid[started], NULL, man_worker, &bulk)) != 0)
+    {
+      /* Not fatal, the threads already running share the work */
+      shm_log_event(SHM_EV_MAN_THREAD, err, 0, (int)started);
+      break;
+    }
+  }
+
+  man_worker(&bulk);
+
+  while(started > 0)
+  {
+    pthread_join(tid[--started], NULL);
+  }
+
+  for(i = 0; i < man->count; i++)
+  {
+    if(man->entry[i].status != 0)
+    {
+      errno = man->entry[i].status;
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : man_worker                                                   *
+* Description   : Body of a bulk operation thread, it takes entries until all  *
+*                 are done.                                                    *
+* Argument      : ctx  Bulk operation context.                                 *
+* Return code   : NULL                                                         *
+\*----------------------------------------------------------------------------*/
+static void *man_worker (void *ctx)
+{
+  struct man_bulk *bulk = ctx;
+  struct shm_man_entry *e;
+  unsigned int i = 0;
+
+  while((i = __atomic_fetch_add(&bulk->next, 1, __ATOMIC_RELAXED))
+                                                            < bulk->man->count)
+  {
+    e = &bulk->man->entry[i];
+    e->status = bulk->fn(e);
+  }
+
+  return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : man_up                                                       *
+* Description   : This function creates or checks one entry.                   *
+* Argument      : e  Entry of the manifest.                                    *
+* Return code   : 0 or errno.                                                  *
+\*----------------------------------------------------------------------------*/
+static int man_up (struct shm_man_entry *e)
+{
+  return (e->kind == SHM_MAN_SHM) ? man_shm_up(e) : man_ipc_up(e);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : man_shm_up                                                   *
+* Description   : This function creates a shared memory and its semaphore as   *
+*                 shm_creat does, or checks the existing one is big enough.    *
+*                 The segment is then bound to its node and pre-faulted.       *
+* Argument      : e  Entry of the manifest.                                    *
+* Return code   : 0 or errno.                                                  *
+\*----------------------------------------------------------------------------*/
+static int man_shm_up (struct shm_man_entry *e)
+{
+  struct shmid_ds buffer;
+  unsigned long mask[MAN_MAX_NODE / (8 * sizeof(unsigned long))];
+  unsigned int page = (unsigned int)sysconf(_SC_PAGESIZE);
+  size_t size = e->size;
+  size_t off = 0;
+  char *ptr;
+  int flags = IPC_CREAT | IPC_EXCL | 0666;
+  int shmid = 0;
+  int sem = 0;
+  int err = 0;
+
+  e->created = 0;
+
+  if(e->page > page)
+  {
+    page   = e->page;
+    flags |= SHM_HUGETLB | ((ffs((int)page) - 1) << SHM_HUGE_SHIFT);
+  }
+  size = (size + page - 1) & ~((size_t)page - 1);
+
+  if((shmid = shmget(e->key, size, flags)) >= 0)
+  {
+    e->created = 1;
+
+    if((sem_creat(e->key + 1)) < 0)
+    {
+      err = errno;
+      shm_log_event(SHM_EV_MAN_SEM, err, e->key, e->line);
+      man_shm_undo(e, shmid, 0);
+      return err;
+    }
+    sem = 1;
+  }
+  else if(errno == EEXIST)
+  {
+    if((shmid = shmget(e->key, 0, 0666)) < 0 ||
+       (shmctl(shmid, IPC_STAT, &buffer)) < 0)
+    {
+      err = errno;
+      shm_log_event(SHM_EV_MAN_SHMGET, err, e->key, e->line);
+      return err;
+    }
+
+    if(buffer.shm_segsz < e->size)
+    {
+      shm_log_event(SHM_EV_MAN_SIZE, EINVAL, e->key, (int)buffer.shm_segsz);
+      return EINVAL;
+    }
+    size = buffer.shm_segsz;
+
+    /* Never reset the semaphore of a live segment, only create a missing one */
+    if((semget(e->key + 1, 1, 0666)) < 0)
+    {
+      if(errno != ENOENT || sem_creat(e->key + 1) < 0)
+      {
+        err = errno;
+        shm_log_event(SHM_EV_MAN_SEM, err, e->key, e->line);
+        return err;
+      }
+      sem = 1;
+    }
+  }
+  else
+  {
+    err = errno;
+    shm_log_event(SHM_EV_MAN_SHMGET, err, e->key, e->line);
+    return err;
+  }
+
+  /* From here what was created is removed again on error */
+  if((ptr = shmat(shmid, NULL, 0)) == (void *)-1)
+  {
+    err = errno;
+    shm_log_event(SHM_EV_MAN_SHMAT, err, e->key, shmid);
+    man_shm_undo(e, shmid, sem);
+    return err;
+  }
+
+  /* An existing segment must have the page size asked for */
+  if(!e->created && e->page != 0 && (off = man_page(ptr)) != 0 && off != page)
+  {
+    shm_log_event(SHM_EV_MAN_PAGE, EINVAL, e->key, (int)(off >> 10));
+    shmdt(ptr);
+    man_shm_undo(e, shmid, sem);
+    return EINVAL;
+  }
+
+  /* The policy is kept by the segment, pages allocated later follow it too */
+  if(e->node >= 0)
+  {
+    memset(mask, 0, sizeof(mask));
+    mask[e->node / (8 * sizeof(unsigned long))] |=
+                                   1UL << (e->node % (8 * sizeof(unsigned long)));
+
+    if((syscall(SYS_mbind, ptr, size, MPOL_PREFERRED, mask,
+                (unsigned long)MAN_MAX_NODE, 0)) < 0)
+    {
+      err = errno;
+      shm_log_event(SHM_EV_MAN_MBIND, err, e->key, e->node);
+      shmdt(ptr);
+      man_shm_undo(e, shmid, sem);
+      return err;
+    }
+  }
+
+  /* Allocate every page now, touch them one by one on kernels before 5.14 */
+  if((madvise(ptr, size, MADV_POPULATE_WRITE)) < 0)
+  {
+    if(errno != EINVAL)
+    {
+      err = errno;
+      shm_log_event(SHM_EV_MAN_PREFAULT, err, e->key, e->line);
+      shmdt(ptr);
+      man_shm_undo(e, shmid, sem);
+      return err;
+    }
+
+    for(off = 0; off < size; off += page)
+    {
+      (void)*(volatile char *)(ptr + off);
+    }
+  }
+
+  shmdt(ptr);
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : man_shm_undo                                                 *
+* Description   : This function removes what man_shm_up created for an entry  *
+*                 that failed afterwards. An existing segment is kept.         *
+* Argument      : e      Entry of the manifest.                                *
+*                 shmid  The segment of the entry.                             *
+*                 sem    1 if the semaphore was created for this entry.        *
+* Return code   : None.                                                        *
+\*----------------------------------------------------------------------------*/
+static void man_shm_undo (struct shm_man_entry *e, int shmid, int sem)
+{
+  if(e->created)
+  {
+    shmctl(shmid, IPC_RMID, 0);
+    e->created = 0;
+  }
+  if(sem)
+  {
+    sem_destroy(e->key + 1);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : man_page                                                     *
+* Description   : This function gives the page size of a mapping, as shown in  *
+*                 /proc/self/smaps.                                            *
+* Argument      : ptr  Start of the mapping.                                   *
+* Return code   : Page size in byte, 0 if it is not known.                     *
+\*----------------------------------------------------------------------------*/
+static unsigned int man_page (void *ptr)
+{
+  FILE *file;
+  char line[SHM_MAN_LINE];
+  unsigned long start = 0;
+  unsigned long end = 0;
+  unsigned int kb = 0;
+  int found = 0;
+
+  if((file = fopen("/proc/self/smaps", "r")) == NULL)
+  {
+    return 0;
+  }
+
+  while(fgets(line, sizeof(line), file) != NULL)
+  {
+    if(sscanf(line, "%lx-%lx ", &start, &end) == 2)
+    {
+      found = (start == (unsigned long)ptr);
+    }
+    else if(found && sscanf(line, "KernelPageSize: %u kB", &kb) == 1)
+    {
+      break;
+    }
+  }
+
+  fclose(file);
+
+  return kb << 10;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : man_ipc_up                                                   *
+* Description   : This function creates a message queue as ipc_creat does, or  *
+*                 gets the existing one, then sets its size if one is given.   *
+* Argument      : e  Entry of the manifest.                                    *
+* Return code   : 0 or errno.                                                  *
+\*----------------------------------------------------------------------------*/
+static int man_ipc_up (struct shm_man_entry *e)
+{
+  struct msqid_ds buffer;
+  int qid = 0;
+  int err = 0;
+
+  e->created = 0;
+
+  if((qid = msgget(e->key, IPC_CREAT | IPC_EXCL | 0666)) >= 0)
+  {
+    e->created = 1;
+  }
+  else if(errno != EEXIST || (qid = msgget(e->key, 0666)) < 0)
+  {
+    err = errno;
+    shm_log_event(SHM_EV_MAN_MSGGET, err, e->key, e->line);
+    return err;
+  }
+
+  if(e->size != 0)
+  {
+    if((msgctl(qid, IPC_STAT, &buffer)) < 0)
+    {
+      err = errno;
+      shm_log_event(SHM_EV_MAN_QBYTES, err, e->key, (int)e->size);
+      if(e->created)
+      {
+        msgctl(qid, IPC_RMID, 0);
+        e->created = 0;
+      }
+      return err;
+    }
+
+    buffer.msg_qbytes = e->size;
+
+    if((msgctl(qid, IPC_SET, &buffer)) < 0)
+    {
+      err = errno;
+      shm_log_event(SHM_EV_MAN_QBYTES, err, e->key, (int)e->size);
+
+      /* Do not leave a queue of the wrong size behind */
+      if(e->created)
+      {
+        msgctl(qid, IPC_RMID, 0);
+        e->created = 0;
+      }
+      return err;
+    }
+  }
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : man_down                                                     *
+* Description   : This function destroys one entry with shm_destroy or         *
+*                 ipc_destroy.                                                 *
+* Argument      : e  Entry of the manifest.                                    *
+* Return code   : 0 or errno, ENOENT is not reported.                          *
+\*----------------------------------------------------------------------------*/
+static int man_down (struct shm_man_entry *e)
+{
+  int ret = 0;
+
+  if(e->kind == SHM_MAN_SHM)
+  {
+    ret = shm_destroy(e->size, e->key);
+  }
+  else
+  {
+    ret = ipc_destroy(e->key);
+  }
+
+  if(ret < 0 && errno != ENOENT)
+  {
+    shm_log_event(SHM_EV_MAN_DESTROY, errno, e->key, e->line);
+    return errno;
+  }
+
+  return 0;
+}
+
+/*---------------------------------------------- Doxygen documentation sectin */
+/*!
+ *  \file shm_manifest.c
+ *  \brief Bulk creation and teardown of the segments and queues of a manifest
+ *  \author Renaud De Koninck
+ *  \version 1.0
+ *  \date 19 October 2026
+ */
+
+
+
+
+/*!
+ *  \fn int shm_manifest_load (struct shm_manifest *man, const char *path)
+ *  This function reads a manifest file, one segment or queue per line:
+ *  \code
+ *  # kind key     size  options
+ *  shm    0x1000  64k   page=2m node=0 name=ticks
+ *  ipc    0x2000        size=1m name=orders
+ *  \endcode
+ *  A shm entry is a shared memory and its semaphore, as made by shm_creat. An
+ *  ipc entry is a message queue, as made by ipc_creat, its size is the max
+ *  number of byte in the queue. Sizes take a k, m or g suffix, a page size is
+ *  at least the system page. A line longer than SHM_MAN_LINE - 2 characters
+ *  is a bad line.
+ *  \param man  Manifest to fill, to free with shm_manifest_free.
+ *  \param path Path of the manifest file.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error, EINVAL for a bad line.
+ *	  The number of that line is then in man->line, the manifest is empty.
+ */
+
+/*!
+ *  \fn void shm_manifest_free (struct shm_manifest *man)
+ *  This function frees a manifest loaded by shm_manifest_load. The segments
+ *  and queues are not touched.
+ *  \param man Manifest to free.
+ */
+
+/*!
+ *  \fn int shm_manifest_creat (struct shm_manifest *man, unsigned int threads)
+ *  This function creates all the segments and queues of a manifest from a pool
+ *  of threads. Those that already exist are checked and kept as is, a segment
+ *  smaller than its entry or with another page size than its page= fails
+ *  with EINVAL. Segments are bound to their NUMA node and every page is
+ *  faulted in, so that the first accesses after a restart do not pay the
+ *  allocation. What an entry created is removed again if a later step of
+ *  that entry fails.
+ *  \param man     Manifest filled by shm_manifest_load.
+ *  \param threads Number of threads, one per CPU if 0.
+ *  \return
+ *	- 0 On success.
+ *	- -1 If an entry failed, errno contains the error of the first failed
+ *	  entry and the status of each entry is set.
+ */
+
+/*!
+ *  \fn int shm_manifest_destroy (struct shm_manifest *man, unsigned int threads)
+ *  This function destroys all the segments and queues of a manifest from a
+ *  pool of threads. An entry that does not exist any more is not an error.
+ *  \param man     Manifest filled by shm_manifest_load.
+ *  \param threads Number of threads, one per CPU if 0.
+ *  \return
+ *	- 0 On success.
+ *	- -1 If an entry failed, errno contains the error of the first failed
+ *	  entry and the status of each entry is set.
+ */
@@ -0,0 +1,694 @@
+/* This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*---------------------------------------------------------- Standard Headers */
+
+#include <errno.h>
+#include <limits.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------- Project Headers */
+
+#include "shm_notify.h"
+#include "shm_log.h"
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------- Defines */
+
+/* Page states */
+#define NOTIFY_NONE   0  /* Not attached, waiters create it, posts look      */
+#define NOTIFY_BUSY   1  /* Being attached, the other threads wait           */
+#define NOTIFY_READY  2
+#define NOTIFY_OFF    3  /* Attach failed or disabled, nothing is notified   */
+
+#define NOTIFY_INIT_MS 100  /* Wait for a concurrent creator                 */
+#define NOTIFY_BUCKETS 64   /* Wake words, a post only wakes its bucket      */
+
+#ifndef SYS_futex_waitv
+#define SYS_futex_waitv 449 /* Linux 5.16                                    */
+#endif
+#define NOTIFY_FUTEX_U32 0x02  /* FUTEX2_SIZE_U32, not private               */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------ Data structure */
+
+/* Wake word, each one on its own cache line */
+struct notify_wake
+{
+  unsigned int seq;      /* Bumped on every post of the bucket, futex word   */
+  unsigned int waiters;  /* Number of threads parked on seq                  */
+} __attribute__((aligned(64)));
+
+/* Notify page. A new segment is all zero which is a valid state, the magic
+   is set last by the creator */
+struct notify_page
+{
+  unsigned int magic;    /* SHM_NOTIFY_MAGIC                                 */
+  struct notify_wake all;  /* Only bumped for waiters without futex_waitv    */
+  struct notify_wake bucket[NOTIFY_BUCKETS];
+  unsigned int gen[SHM_NOTIFY_SLOTS] __attribute__((aligned(64)));
+};
+
+/* struct futex_waitv of linux/futex.h, missing from older headers */
+struct notify_waitv
+{
+  unsigned long long val;
+  unsigned long long uaddr;
+  unsigned int flags;
+  unsigned int reserved;
+};
+
+/* struct __kernel_timespec */
+struct notify_time
+{
+  long long tv_sec;
+  long long tv_nsec;
+};
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------- Functions prototype */
+
+/* These functions are for library's internal use */
+static struct notify_page *notify_page   (int creat);
+static struct notify_page *notify_attach (int creat);
+static unsigned int       notify_slot   (key_t key);
+static unsigned int       notify_bucket (key_t key);
+static int                notify_multi  (struct notify_page *page,
+                                         unsigned long long mask,
+                                         const unsigned int *val,
+                                         unsigned int timeout_us);
+static int                notify_all    (struct notify_page *page,
+                                         unsigned long long mask,
+                                         const unsigned int *val,
+                                         const struct timespec *timeout);
+
+/*----------------------------------------------------------------------------*/
+/*--------------------------------------------------------------- Global data */
+
+static struct notify_page *notify_ptr = NULL;
+static unsigned int       notify_state = NOTIFY_NONE;
+static key_t              notify_key = SHM_NOTIFY_KEY;
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------- Functions */
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_notify_init                                              *
+* Description   : This function chooses the notify page of the process and     *
+*                 creates it. Posts only go to a page that a waiter created,   *
+*                 it is created by this call or by the first wait.             *
+* Argument      : key  Key of the page, SHM_NOTIFY_KEY if 0, SHM_NOTIFY_OFF to *
+*                      notify nothing.                                         *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set.                                *
+\*----------------------------------------------------------------------------*/
+extern int shm_notify_init (key_t key)
+{
+  unsigned int state = NOTIFY_NONE;
+
+  if(!__atomic_compare_exchange_n(&notify_state, &state, NOTIFY_BUSY, 0,
+                                  __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+  {
+    errno = EBUSY;
+    return -1;
+  }
+
+  if(key == SHM_NOTIFY_OFF)
+  {
+    __atomic_store_n(&notify_state, NOTIFY_OFF, __ATOMIC_RELEASE);
+    return 0;
+  }
+
+  notify_key = (key != 0) ? key : SHM_NOTIFY_KEY;
+
+  return (notify_attach(1) != NULL) ? 0 : -1;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_notify_ready                                             *
+* Description   : This function tells whether changes are notified, creating   *
+*                 the page if needed. Without page, waiters must poll.         *
+* Argument      : None.                                                        *
+* Return code   : 1      The notify page is attached.                          *
+*                 0      It is not available or disabled.                      *
+\*----------------------------------------------------------------------------*/
+extern int shm_notify_ready (void)
+{
+  return (notify_page(1) != NULL);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_notify_post                                              *
+* Description   : This function tells the waiters that a shared memory or an   *
+*                 IPC changed. shm_write and write_message call it. Nothing is *
+*                 done while no waiter created the page, the kernel is only    *
+*                 entered if someone is parked on the bucket of the key.       *
+* Argument      : key  The key of the shared memory or of the IPC.             *
+* Return code   : 0      On success or if nobody waits.                        *
+\*----------------------------------------------------------------------------*/
+extern int shm_notify_post (key_t key)
+{
+  struct notify_page *page;
+  struct notify_wake *wake;
+
+  if((page = notify_page(0)) == NULL)
+  {
+    return 0;
+  }
+
+  wake = &page->bucket[notify_bucket(key)];
+
+  __atomic_add_fetch(&page->gen[notify_slot(key)], 1, __ATOMIC_SEQ_CST);
+  __atomic_add_fetch(&wake->seq, 1, __ATOMIC_SEQ_CST);
+
+  if(__atomic_load_n(&wake->waiters, __ATOMIC_SEQ_CST) != 0)
+  {
+    syscall(SYS_futex, &wake->seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+  }
+
+  if(__atomic_load_n(&page->all.waiters, __ATOMIC_SEQ_CST) != 0)
+  {
+    __atomic_add_fetch(&page->all.seq, 1, __ATOMIC_SEQ_CST);
+    syscall(SYS_futex, &page->all.seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+  }
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_notify_gen                                               *
+* Description   : This function reads the generation of a key. It changes at   *
+*                 least once after each post on that key, keys sharing a slot  *
+*                 give spurious changes.                                       *
+* Argument      : key  The key of the shared memory or of the IPC.             *
+* Return code   : Generation of the key, 0 if the page is not available.       *
+\*----------------------------------------------------------------------------*/
+extern unsigned int shm_notify_gen (key_t key)
+{
+  struct notify_page *page;
+
+  if((page = notify_page(1)) == NULL)
+  {
+    return 0;
+  }
+
+  return __atomic_load_n(&page->gen[notify_slot(key)], __ATOMIC_ACQUIRE);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_notify_seq                                               *
+* Description   : This function reads the wake sequence of a key, it changes   *
+*                 after every post on any key of its bucket. It is read before *
+*                 polling the key and then given to shm_notify_wait.           *
+* Argument      : key  The key of the shared memory or of the IPC.             *
+* Return code   : Wake sequence, 0 if the page is not available.               *
+\*----------------------------------------------------------------------------*/
+extern unsigned int shm_notify_seq (key_t key)
+{
+  struct notify_page *page;
+
+  if((page = notify_page(1)) == NULL)
+  {
+    return 0;
+  }
+
+  return __atomic_load_n(&page->bucket[notify_bucket(key)].seq,
+                         __ATOMIC_SEQ_CST);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_notify_wait                                              *
+* Description   : This function parks the caller until a post on the bucket of *
+*                 key happens after seq was read, or until the timeout.        *
+* Argument      : key         The key of the shared memory or of the IPC.      *
+*                 seq         Value returned by shm_notify_seq.                *
+*                 timeout_us  Max time to wait in micro second, 0 for ever.    *
+* Return code   : 0      On post or timeout.                                   *
+*                 -1     On error errno is set.                                *
+\*----------------------------------------------------------------------------*/
+extern int shm_notify_wait (key_t key, unsigned int seq,
+                            unsigned int timeout_us)
+{
+  return shm_notify_waitv(&key, &seq, 1, timeout_us);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_notify_waitv                                             *
+* Description   : This function parks the caller until a post on the bucket of *
+*                 any of the keys happens after its seq was read, or until the *
+*                 timeout. Without notify page it just sleeps for the timeout. *
+* Argument      : keys        The keys of the shared memories or of the IPC.   *
+*                 seqs        Values returned by shm_notify_seq for each key.  *
+*                 n           Number of keys.                                  *
+*                 timeout_us  Max time to wait in micro second, 0 for ever.    *
+* Return code   : 0      On post or timeout.                                   *
+*                 -1     On error errno is set.                                *
+\*----------------------------------------------------------------------------*/
+extern int shm_notify_waitv (const key_t *keys, const unsigned int *seqs,
+                             unsigned int n, unsigned int timeout_us)
+{
+  struct notify_page *page;
+  struct timespec timeout;
+  unsigned int val[NOTIFY_BUCKETS];
+  unsigned long long mask = 0;
+  unsigned int i = 0;
+  unsigned int b = 0;
+  int ret = 0;
+
+  timeout.tv_sec  = timeout_us / 1000000;
+  timeout.tv_nsec = (timeout_us % 1000000) * 1000L;
+
+  if((page = notify_page(1)) == NULL || n == 0)
+  {
+    if(timeout_us != 0)
+    {
+      nanosleep(&timeout, NULL);
+    }
+    else
+    {
+      pause();
+    }
+    return 0;
+  }
+
+  /* First seq of each bucket, a later one is equal or newer and thus already
+     changed if it differs */
+  for(i = 0; i < n; i++)
+  {
+    b = notify_bucket(keys[i]);
+    if((mask & (1ULL << b)) == 0)
+    {
+      mask |= 1ULL << b;
+      val[b] = seqs[i];
+    }
+  }
+
+  for(b = 0; b < NOTIFY_BUCKETS; b++)
+  {
+    if(mask & (1ULL << b))
+    {
+      __atomic_add_fetch(&page->bucket[b].waiters, 1, __ATOMIC_SEQ_CST);
+    }
+  }
+
+  if((mask & (mask - 1)) == 0)
+  {
+    b = (unsigned int)__builtin_ctzll(mask);
+    ret = (int)syscall(SYS_futex, &page->bucket[b].seq, FUTEX_WAIT, val[b],
+                       (timeout_us != 0) ? &timeout : NULL, NULL, 0);
+  }
+  else if((ret = notify_multi(page, mask, val, timeout_us)) < 0 &&
+          errno == ENOSYS)
+  {
+    ret = notify_all(page, mask, val, (timeout_us != 0) ? &timeout : NULL);
+  }
+
+  if(ret < 0 && errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT)
+  {
+    shm_log_event(SHM_EV_NOTIFY_WAIT, errno, notify_key, (int)n);
+    ret = -1;
+  }
+  else
+  {
+    ret = 0;
+  }
+
+  for(b = 0; b < NOTIFY_BUCKETS; b++)
+  {
+    if(mask & (1ULL << b))
+    {
+      __atomic_sub_fetch(&page->bucket[b].waiters, 1, __ATOMIC_SEQ_CST);
+    }
+  }
+
+  return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : notify_page                                                  *
+* Description   : This function gives the notify page, it is attached by the   *
+*                 first call of the process. While another thread attaches it, *
+*                 the caller waits for the result.                             *
+* Argument      : creat  1 to create the page, 0 to only use an existing one.  *
+* Return code   : Pointer to the page, NULL if it is not available.            *
+\*----------------------------------------------------------------------------*/
+static struct notify_page *notify_page (int creat)
+{
+  unsigned int state = NOTIFY_NONE;
+
+  for(;;)
+  {
+    state = __atomic_load_n(&notify_state, __ATOMIC_ACQUIRE);
+
+    if(state == NOTIFY_READY)
+    {
+      return notify_ptr;
+    }
+
+    if(state == NOTIFY_OFF)
+    {
+      return NULL;
+    }
+
+    if(state == NOTIFY_NONE &&
+       __atomic_compare_exchange_n(&notify_state, &state, NOTIFY_BUSY, 0,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+    {
+      return notify_attach(creat);
+    }
+
+    sched_yield();
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : notify_attach                                                *
+* Description   : This function maps the notify page, the caller has set the   *
+*                 state to busy. The first waiter creates the page, it is      *
+*                 never destroyed. A segment already holding the key is only   *
+*                 used if it has the magic and the size of a notify page.      *
+* Argument      : creat  1 to create the page, 0 to only use an existing one.  *
+* Return code   : Pointer to the page, NULL if it is not available.            *
+\*----------------------------------------------------------------------------*/
+static struct notify_page *notify_attach (int creat)
+{
+  struct notify_page *page = (void *)-1;
+  struct shmid_ds ds;
+  int shmid = -1;
+  int i = 0;
+
+  if(creat && (shmid = shmget(notify_key, sizeof(struct notify_page),
+                              IPC_CREAT | IPC_EXCL | 0666)) >= 0)
+  {
+    if((page = shmat(shmid, NULL, 0)) != (void *)-1)
+    {
+      __atomic_store_n(&page->magic, SHM_NOTIFY_MAGIC, __ATOMIC_RELEASE);
+    }
+  }
+  else if((!creat || errno == EEXIST) &&
+          (shmid = shmget(notify_key, 0, 0666)) >= 0 &&
+          shmctl(shmid, IPC_STAT, &ds) == 0)
+  {
+    if(ds.shm_segsz != sizeof(struct notify_page) ||
+       (page = shmat(shmid, NULL, 0)) == (void *)-1)
+    {
+      shm_log_event(SHM_EV_NOTIFY_MAGIC, EEXIST, notify_key,
+                    (int)ds.shm_segsz);
+      __atomic_store_n(&notify_state, NOTIFY_OFF, __ATOMIC_RELEASE);
+      errno = EEXIST;
+      return NULL;
+    }
+
+    /* The creator may still be setting the magic */
+    while(__atomic_load_n(&page->magic, __ATOMIC_ACQUIRE) != SHM_NOTIFY_MAGIC &&
+          i++ < NOTIFY_INIT_MS)
+    {
+      usleep(1000);
+    }
+
+    if(__atomic_load_n(&page->magic, __ATOMIC_ACQUIRE) != SHM_NOTIFY_MAGIC)
+    {
+      shm_log_event(SHM_EV_NOTIFY_MAGIC, EEXIST, notify_key, shmid);
+      shmdt(page);
+      __atomic_store_n(&notify_state, NOTIFY_OFF, __ATOMIC_RELEASE);
+      errno = EEXIST;
+      return NULL;
+    }
+  }
+  else if(!creat && shmid < 0 && errno == ENOENT)
+  {
+    /* No waiter yet, a later post looks again */
+    __atomic_store_n(&notify_state, NOTIFY_NONE, __ATOMIC_RELEASE);
+    return NULL;
+  }
+
+  if(page == (void *)-1)
+  {
+    shm_log_event(SHM_EV_NOTIFY_ATTACH, errno, notify_key, shmid);
+    __atomic_store_n(&notify_state, NOTIFY_OFF, __ATOMIC_RELEASE);
+    return NULL;
+  }
+
+  notify_ptr = page;
+  __atomic_store_n(&notify_state, NOTIFY_READY, __ATOMIC_RELEASE);
+
+  return page;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : notify_slot                                                  *
+* Description   : This function gives the generation counter of a key.         *
+* Argument      : key  The key of the shared memory or of the IPC.             *
+* Return code   : Index in gen.                                                *
+\*----------------------------------------------------------------------------*/
+static unsigned int notify_slot (key_t key)
+{
+  return (((unsigned int)key * 2654435761U) >> 20) & (SHM_NOTIFY_SLOTS - 1);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : notify_bucket                                                *
+* Description   : This function gives the wake word of a key.                  *
+* Argument      : key  The key of the shared memory or of the IPC.             *
+* Return code   : Index in bucket.                                             *
+\*----------------------------------------------------------------------------*/
+static unsigned int notify_bucket (key_t key)
+{
+  return notify_slot(key) & (NOTIFY_BUCKETS - 1);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : notify_multi                                                 *
+* Description   : This function parks the caller on several buckets at once    *
+*                 with futex_waitv.                                            *
+* Argument      : page        The notify page.                                 *
+*                 mask        Buckets to wait on.                              *
+*                 val         Expected seq of each bucket in mask.             *
+*                 timeout_us  Max time to wait in micro second, 0 for ever.    *
+* Return code   : >= 0   On post.                                              *
+*                 -1     On timeout or error errno is set, ENOSYS if the       *
+*                        kernel has no futex_waitv.                            *
+\*----------------------------------------------------------------------------*/
+static int notify_multi (struct notify_page *page, unsigned long long mask,
+                         const unsigned int *val, unsigned int timeout_us)
+{
+  struct notify_waitv vec[NOTIFY_BUCKETS];
+  struct notify_time until;
+  struct timespec now;
+  unsigned int count = 0;
+  unsigned int b = 0;
+
+  for(b = 0; b < NOTIFY_BUCKETS; b++)
+  {
+    if(mask & (1ULL << b))
+    {
+      vec[count].val      = val[b];
+      vec[count].uaddr    = (unsigned long long)(unsigned long)
+                            &page->bucket[b].seq;
+      vec[count].flags    = NOTIFY_FUTEX_U32;
+      vec[count].reserved = 0;
+      count++;
+    }
+  }
+
+  /* futex_waitv takes an absolute time */
+  if(timeout_us != 0)
+  {
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    until.tv_sec  = now.tv_sec + timeout_us / 1000000;
+    until.tv_nsec = now.tv_nsec + (timeout_us % 1000000) * 1000LL;
+    if(until.tv_nsec >= 1000000000LL)
+    {
+      until.tv_sec++;
+      until.tv_nsec -= 1000000000LL;
+    }
+  }
+
+  return (int)syscall(SYS_futex_waitv, vec, count, 0,
+                      (timeout_us != 0) ? &until : NULL, CLOCK_MONOTONIC);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : notify_all                                                   *
+* Description   : This function parks the caller on the common word when the   *
+*                 kernel has no futex_waitv. Posts only bump it while someone  *
+*                 waits on it, so the buckets are checked after registering.   *
+* Argument      : page     The notify page.                                    *
+*                 mask     Buckets to wait on.                                 *
+*                 val      Expected seq of each bucket in mask.                *
+*                 timeout  Max time to wait, NULL for ever.                    *
+* Return code   : 0      On post.                                              *
+*                 -1     On timeout or error errno is set.                     *
+\*----------------------------------------------------------------------------*/
+static int notify_all (struct notify_page *page, unsigned long long mask,
+                       const unsigned int *val, const struct timespec *timeout)
+{
+  unsigned int seq = 0;
+  unsigned int b = 0;
+  int ret = 0;
+
+  __atomic_add_fetch(&page->all.waiters, 1, __ATOMIC_SEQ_CST);
+  seq = __atomic_load_n(&page->all.seq, __ATOMIC_SEQ_CST);
+
+  for(b = 0; b < NOTIFY_BUCKETS; b++)
+  {
+    if((mask & (1ULL << b)) &&
+       __atomic_load_n(&page->bucket[b].seq, __ATOMIC_SEQ_CST) != val[b])
+    {
+      break;
+    }
+  }
+
+  if(b == NOTIFY_BUCKETS)
+  {
+    ret = (int)syscall(SYS_futex, &page->all.seq, FUTEX_WAIT, seq, timeout,
+                       NULL, 0);
+  }
+
+  __atomic_sub_fetch(&page->all.waiters, 1, __ATOMIC_SEQ_CST);
+
+  return ret;
+}
+
+/*---------------------------------------------- Doxygen documentation sectin */
+/*!
+ *  \file shm_notify.c
+ *  \brief Change notification of the shared memories and IPC
+ *  \author Renaud De Koninck
+ *  \version 1.0
+ *  \date 19 October 2026
+ */
+
+
+
+
+/*!
+ *  \fn int shm_notify_init (key_t key)
+ *  This function chooses the notify page of the process and creates it.
+ *  Notification is opt-in: shm_write and write_message only post to a page
+ *  that exists, and the page is created by this function or by the first
+ *  wait, e.g. of the coroutine layer. A process that never waits does not
+ *  create anything. The page SHM_NOTIFY_KEY is shared by every process using
+ *  the library on the host and is never destroyed. Give another key to keep
+ *  a group of processes apart, or SHM_NOTIFY_OFF so that shm_write and
+ *  write_message do not touch any page. A segment already holding the key is
+ *  only used if it is a notify page.
+ *  \param key Key of the page, SHM_NOTIFY_KEY if 0, SHM_NOTIFY_OFF to notify
+ *             nothing.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error, EBUSY if the page is
+ *	  already chosen, EEXIST if the key is used by something else.
+ */
+
+/*!
+ *  \fn int shm_notify_ready (void)
+ *  This function tells whether changes are notified, creating the page if
+ *  needed. Without page, shm_notify_gen and shm_notify_seq never change and
+ *  the shared memories and IPC must be polled.
+ *  \return
+ *	- 1 The notify page is attached.
+ *	- 0 It is not available or it is disabled.
+ */
+
+/*!
+ *  \fn int shm_notify_post (key_t key)
+ *  This function tells the waiters that a shared memory or an IPC changed. It
+ *  is called by shm_write and write_message. The notify page is a shared
+ *  memory with one generation counter per key hash and 64 wake words that
+ *  keys are spread on, the kernel is entered only if someone is parked on
+ *  the word of the key. While no waiter created the page, a post only looks
+ *  for it.
+ *  \param key The key of the shared memory or of the IPC.
+ *  \return
+ *	- 0 On success or if nobody waits.
+ */
+
+/*!
+ *  \fn unsigned int shm_notify_gen (key_t key)
+ *  This function reads the generation of a key without system call. It
+ *  changes at least once after each post on that key, keys sharing a counter
+ *  give spurious changes.
+ *  \param key The key of the shared memory or of the IPC.
+ *  \return Generation of the key, 0 if the notify page is not available.
+ */
+
+/*!
+ *  \fn unsigned int shm_notify_seq (key_t key)
+ *  This function reads the wake sequence of a key, it changes after every
+ *  post on any key sharing its wake word. Read it before polling the key,
+ *  then give it to shm_notify_wait so that a post done while polling is not
+ *  missed.
+ *  \param key The key of the shared memory or of the IPC.
+ *  \return Wake sequence, 0 if the notify page is not available.
+ */
+
+/*!
+ *  \fn int shm_notify_wait (key_t key, unsigned int seq, unsigned int timeout_us)
+ *  This function parks the caller until a post on the wake word of key
+ *  happens after seq was read, or until the timeout.
+ *  \warning Writers that do not use this library do not post, use a timeout
+ *  if such writers exist.
+ *  \param key        The key of the shared memory or of the IPC.
+ *  \param seq        Value returned by shm_notify_seq.
+ *  \param timeout_us Max time to wait in micro second, 0 to wait for ever.
+ *  \return
+ *	- 0 On post or timeout.
+ *	- -1 On Faillure & errno contains system error.
+ */
+
+/*!
+ *  \fn int shm_notify_waitv (const key_t *keys, const unsigned int *seqs, unsigned int n, unsigned int timeout_us)
+ *  This function parks the caller until a post on the wake word of any of
+ *  the keys happens after its seq was read, or until the timeout. It uses
+ *  futex_waitv, on older kernels it parks on a common word that posts only
+ *  bump while someone waits on it.
+ *  \param keys       The keys of the shared memories or of the IPC.
+ *  \param seqs       Values returned by shm_notify_seq for each key.
+ *  \param n          Number of keys.
+ *  \param timeout_us Max time to wait in micro second, 0 to wait for ever.
+ *  \return
+ *	- 0 On post or timeout.
+ *	- -1 On Faillure & errno contains system error.
+ */
@@ -0,0 +1,1154 @@
+/* This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*---------------------------------------------------------- Standard Headers */
+
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------- Project Headers */
+
+#include "shm_rpc.h"
+#include "shm_log.h"
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------- Defines */
+
+/* #define DEBUG */
+
+#define SHM_RPC_MAGIC     0x52504331 /* "RPC1" marks an initialized segment  */
+#define SHM_RPC_LINE      64         /* Slots are cache line aligned         */
+#define SHM_RPC_SPIN      4096       /* Polls before parking on a futex      */
+#define SHM_RPC_MAX_WORKS 64         /* Max server threads per segment       */
+#define SHM_RPC_INIT_MS   100        /* Wait for a concurrent creator        */
+
+/* Slot states */
+#define SLOT_FREE     0
+#define SLOT_CLAIMED  1  /* Client is filling the request                    */
+#define SLOT_REQUEST  2  /* Request is waiting for a worker                  */
+#define SLOT_BUSY     3  /* Worker is running the handler                    */
+#define SLOT_REPLY    4  /* Reply is ready for the client                    */
+
+/* Orphan handshake, whoever comes second gives the slot back */
+#define ORPHAN_NONE   0
+#define ORPHAN_CLIENT 1  /* Call cancelled, the client will not read it      */
+#define ORPHAN_REPLY  2  /* Reply written, the worker did not free the slot  */
+
+#if defined(__x86_64__) || defined(__i386__)
+#define cpu_relax() __builtin_ia32_pause()
+#else
+#define cpu_relax() __asm__ __volatile__("" ::: "memory")
+#endif
+
+#define rpc_load(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define rpc_store(p, v)  __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define rpc_add(p, v)    __atomic_add_fetch((p), (v), __ATOMIC_SEQ_CST)
+#define rpc_cas(p, o, n) __atomic_compare_exchange_n((p), &(o), (n), 0, \
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------ Data structure */
+
+/* Segment header, followed by the slots array */
+struct rpc_hdr
+{
+  unsigned int magic;
+  unsigned int slots;
+  unsigned int slot_size;  /* Payload size of a slot in byte                 */
+  unsigned int stride;     /* Distance between two slots in byte             */
+  unsigned int seq;        /* Last correlation id given                      */
+  unsigned int next;       /* Hint for the free slot search                  */
+  unsigned int running;    /* Cleared by shm_rpc_stop                        */
+  int          server;     /* Process running shm_rpc_serve                  */
+  unsigned int doorbell;   /* Bumped on every submit, workers park on it     */
+  unsigned int sleepers;   /* Number of workers parked on doorbell           */
+} __attribute__((aligned(SHM_RPC_LINE)));
+
+/* Header of a slot, followed by slot_size byte of payload */
+struct rpc_slot
+{
+  unsigned int state;
+  unsigned int waiting;    /* Client is parked on state                      */
+  unsigned int id;         /* Correlation id of the current call             */
+  unsigned int size;       /* Request size, then reply size                  */
+  int          status;     /* 0 or errno of the handler                      */
+  int          pid;        /* Client that submitted the call                 */
+  unsigned int orphan;     /* ORPHAN_xxx                                     */
+  char         data[];
+};
+
+/* Worker thread context */
+struct rpc_worker
+{
+  struct shm_rpc  *rpc;
+  shm_rpc_handler handler;
+  void            *arg;
+  unsigned int    first;   /* First slot scanned by this worker              */
+};
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------- Functions prototype */
+
+/* These functions are for library's internal use */
+static struct rpc_slot *rpc_slot     (struct rpc_hdr *hdr, unsigned int i);
+static int             rpc_futex     (unsigned int *addr, int op,
+                                      unsigned int val,
+                                      const struct timespec *timeout);
+static void            rpc_complete  (struct rpc_slot *slot, int status);
+static int             rpc_reap      (struct rpc_hdr *hdr, int busy);
+static int             rpc_dead      (int pid);
+static int             rpc_scan      (struct rpc_worker *w);
+static void            *rpc_worker   (void *ctx);
+
+/*----------------------------------------------------------------------------*/
+/*--------------------------------------------------------------- Global data */
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------- Functions */
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_rpc_creat                                                *
+* Description   : This function creates a shared memory holding the RPC slots. *
+*                 Each slot carries one request and, once served, its reply.   *
+*                 A RPC segment that already exists with the same geometry is  *
+*                 kept as is, calls in flight are not touched.                 *
+* Argument      : key        The key that will be used to create the segment.  *
+*                 slots      Number of calls that can be outstanding.          *
+*                 slot_size  Max size of a request or a reply in byte.         *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set, EEXIST if the key is used by   *
+*                        something else, EINVAL if the geometry differs.       *
+\*----------------------------------------------------------------------------*/
+extern int shm_rpc_creat (key_t key, unsigned int slots, unsigned int slot_size)
+{
+  int shmid = 0;
+  unsigned int stride = 0;
+  size_t size = 0;
+  struct rpc_hdr *hdr;
+  int i = 0;
+
+  if(slots == 0 || slots > SHM_RPC_MAX_SLOTS || slot_size == 0)
+  {
+    shm_log_event(SHM_EV_RPC_CREAT_GEOMETRY, EINVAL, key, (int)slots);
+    errno = EINVAL;
+    return -1;
+  }
+
+  stride = (sizeof(struct rpc_slot) + slot_size + SHM_RPC_LINE - 1)
+         & ~(SHM_RPC_LINE - 1);
+  size   = sizeof(struct rpc_hdr) + (size_t)slots * stride;
+
+  if((shmid = shmget(key, size, IPC_CREAT | IPC_EXCL | 0666)) < 0)
+  {
+    if(errno != EEXIST)
+    {
+      shm_log_event(SHM_EV_RPC_CREAT_SHMGET, errno, key, (int)size);
+      return -1;
+    }
+
+    /* Created by another process, keep it if it is the same RPC segment */
+    if((shmid = shmget(key, 0, 0666)) < 0 ||
+       (hdr = shmat(shmid, NULL, 0)) == (void *)-1)
+    {
+      shm_log_event(SHM_EV_RPC_CREAT_SHMGET, errno, key, (int)size);
+      return -1;
+    }
+
+    /* The creator may still be filling the header */
+    while(rpc_load(&hdr->magic) != SHM_RPC_MAGIC && i++ < SHM_RPC_INIT_MS)
+    {
+      usleep(1000);
+    }
+
+    if(rpc_load(&hdr->magic) != SHM_RPC_MAGIC)
+    {
+      shm_log_event(SHM_EV_RPC_CREAT_EXISTS, EEXIST, key, shmid);
+      shmdt(hdr);
+      errno = EEXIST;
+      return -1;
+    }
+
+    if(hdr->slots != slots || hdr->slot_size != slot_size)
+    {
+      shm_log_event(SHM_EV_RPC_CREAT_GEOMETRY, EINVAL, key, (int)hdr->slots);
+      shmdt(hdr);
+      errno = EINVAL;
+      return -1;
+    }
+
+    shmdt(hdr);
+    return 0;
+  }
+
+  if((hdr = shmat(shmid, NULL, 0)) == (void *)-1)
+  {
+    shm_log_event(SHM_EV_RPC_CREAT_SHMAT, errno, key, shmid);
+    return -1;
+  }
+
+  /* Fields first, magic last so that attach never sees a partial header */
+  memset(hdr, 0, size);
+  hdr->slots     = slots;
+  hdr->slot_size = slot_size;
+  hdr->stride    = stride;
+  rpc_store(&hdr->magic, SHM_RPC_MAGIC);
+
+#ifdef DEBUG
+  shm_log_event(SHM_EV_DBG_RPC_CREATED, 0, key, (int)slots);
+#endif
+
+  shmdt(hdr);
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_rpc_destroy                                              *
+* Description   : This function destroys a RPC shared memory.                  *
+* Argument      : key  The key of the RPC segment to destroy.                  *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set.                                *
+\*----------------------------------------------------------------------------*/
+extern int shm_rpc_destroy (key_t key)
+{
+  int shmid = 0;
+
+  if((shmid = shmget(key, 0, 0666)) < 0)
+  {
+    shm_log_event(SHM_EV_RPC_DESTROY_SHMGET, errno, key, 0);
+    return -1;
+  }
+
+  if((shmctl(shmid, IPC_RMID, 0)) < 0)
+  {
+    shm_log_event(SHM_EV_RPC_DESTROY_RMID, errno, key, shmid);
+    return -1;
+  }
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_rpc_attach                                               *
+* Description   : This function maps a RPC segment to the current process.    *
+*                 The mapping is kept until shm_rpc_detach so that calls do    *
+*                 not pay a shmat each.                                        *
+* Argument      : rpc  Handle to fill.                                         *
+*                 key  The key of the RPC segment.                             *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set.                                *
+\*----------------------------------------------------------------------------*/
+extern int shm_rpc_attach (struct shm_rpc *rpc, key_t key)
+{
+  struct rpc_hdr *hdr;
+
+  if((rpc->shmid = shmget(key, 0, 0666)) < 0)
+  {
+    shm_log_event(SHM_EV_RPC_ATTACH_SHMGET, errno, key, 0);
+    return -1;
+  }
+
+  if((hdr = shmat(rpc->shmid, NULL, 0)) == (void *)-1)
+  {
+    shm_log_event(SHM_EV_RPC_ATTACH_SHMAT, errno, key, rpc->shmid);
+    return -1;
+  }
+
+  if(rpc_load(&hdr->magic) != SHM_RPC_MAGIC)
+  {
+    shm_log_event(SHM_EV_RPC_ATTACH_MAGIC, EINVAL, key, (int)hdr->magic);
+    shmdt(hdr);
+    errno = EINVAL;
+    return -1;
+  }
+
+  rpc->key  = key;
+  rpc->base = hdr;
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_rpc_detach                                               *
+* Description   : This function unmaps a RPC segment from the current process. *
+* Argument      : rpc  Handle filled by shm_rpc_attach.                        *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set.                                *
+\*----------------------------------------------------------------------------*/
+extern int shm_rpc_detach (struct shm_rpc *rpc)
+{
+  if((shmdt(rpc->base)) < 0)
+  {
+    shm_log_event(SHM_EV_RPC_DETACH_SHMDT, errno, rpc->key, rpc->shmid);
+    return -1;
+  }
+
+  rpc->base = NULL;
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_rpc_submit                                               *
+* Description   : This function copies a request in a free slot and rings the  *
+*                 server. It does not wait for the reply, several calls can    *
+*                 be outstanding and are completed with shm_rpc_wait.          *
+* Argument      : rpc   Handle filled by shm_rpc_attach.                       *
+*                 data  Pointer to the request.                                *
+*                 size  Size of the request in byte.                           *
+*                 call  Filled with the slot and the correlation id.           *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set, EAGAIN if all slots are used,  *
+*                        ESHUTDOWN if no server is running.                    *
+\*----------------------------------------------------------------------------*/
+extern int shm_rpc_submit (struct shm_rpc *rpc, void *data, unsigned int size,
+                           struct shm_rpc_call *call)
+{
+  struct rpc_hdr *hdr = rpc->base;
+  struct rpc_slot *slot = NULL;
+  unsigned int first = 0;
+  unsigned int retry = 0;
+  unsigned int i = 0;
+  unsigned int state = 0;
+
+  if(size > hdr->slot_size)
+  {
+    shm_log_event(SHM_EV_RPC_SUBMIT_SIZE, EMSGSIZE, rpc->key, (int)size);
+    errno = EMSGSIZE;
+    return -1;
+  }
+
+  if(!rpc_load(&hdr->running))
+  {
+    errno = ESHUTDOWN;
+    return -1;
+  }
+
+  /* Start from a rotating hint so that clients do not fight for slot 0 */
+  first = rpc_add(&hdr->next, 1);
+
+  for(retry = 0; retry < 2; retry++)
+  {
+    for(i = 0; i < hdr->slots; i++)
+    {
+      slot  = rpc_slot(hdr, (first + i) % hdr->slots);
+      state = SLOT_FREE;
+
+      if(rpc_load(&slot->state) == SLOT_FREE &&
+         rpc_cas(&slot->state, state, SLOT_CLAIMED))
+      {
+        break;
+      }
+    }
+
+    /* All used, slots of dead clients may be given back */
+    if(i < hdr->slots || rpc_reap(hdr, 0) == 0)
+    {
+      break;
+    }
+  }
+
+  if(i == hdr->slots)
+  {
+    errno = EAGAIN;
+    return -1;
+  }
+
+  memcpy(slot->data, data, size);
+  slot->size    = size;
+  slot->status  = 0;
+  slot->waiting = 0;
+  slot->pid     = getpid();
+  slot->orphan  = ORPHAN_NONE;
+  slot->id      = rpc_add(&hdr->seq, 1);
+
+  call->slot = (first + i) % hdr->slots;
+  call->id   = slot->id;
+
+  rpc_store(&slot->state, SLOT_REQUEST);
+
+  /* A stop that swept the slots before the request was seen would leave it
+     there for ever, take it back unless a worker or the stop got it */
+  if(!rpc_load(&hdr->running))
+  {
+    state = SLOT_REQUEST;
+    if(rpc_cas(&slot->state, state, SLOT_FREE))
+    {
+      errno = ESHUTDOWN;
+      return -1;
+    }
+  }
+
+  /* Only enter the kernel when a worker is actually parked */
+  rpc_add(&hdr->doorbell, 1);
+  if(rpc_load(&hdr->sleepers) != 0)
+  {
+    rpc_futex(&hdr->doorbell, FUTEX_WAKE, 1, NULL);
+  }
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_rpc_poll                                                 *
+* Description   : This function checks without blocking if a call is served.   *
+* Argument      : rpc   Handle filled by shm_rpc_attach.                       *
+*                 call  Call filled by shm_rpc_submit.                         *
+* Return code   : 0    if the reply is not ready                               *
+*                 1    if the reply is ready                                   *
+*                -1    In case of error & errno is set.                        *
+\*----------------------------------------------------------------------------*/
+extern int shm_rpc_poll (struct shm_rpc *rpc, struct shm_rpc_call *call)
+{
+  struct rpc_hdr *hdr = rpc->base;
+  struct rpc_slot *slot;
+
+  if(call->slot >= hdr->slots ||
+     (slot = rpc_slot(hdr, call->slot))->id != call->id)
+  {
+    errno = EINVAL;
+    return -1;
+  }
+
+  return (rpc_load(&slot->state) == SLOT_REPLY);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_rpc_wait                                                 *
+* Description   : This function waits for the reply of a call, copies it and   *
+*                 gives the slot back, without timeout.                        *
+* Argument      : rpc   Handle filled by shm_rpc_attach.                       *
+*                 call  Call filled by shm_rpc_submit.                         *
+*                 data  Pointer to the buffer to copy the reply.               *
+*                 size  In size of data, out size of the reply in byte.        *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set, it is the handler errno if     *
+*                        the handler failed.                                   *
+\*----------------------------------------------------------------------------*/
+extern int shm_rpc_wait (struct shm_rpc *rpc, struct shm_rpc_call *call,
+                         void *data, unsigned int *size)
+{
+  return shm_rpc_timedwait(rpc, call, data, size, 0);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_rpc_timedwait                                            *
+* Description   : This function waits for the reply of a call, copies it and   *
+*                 gives the slot back. The slot is polled for a while before   *
+*                 the caller parks on a futex. On timeout the call is still    *
+*                 outstanding, wait again or give it up with shm_rpc_cancel.   *
+* Argument      : rpc         Handle filled by shm_rpc_attach.                 *
+*                 call        Call filled by shm_rpc_submit.                   *
+*                 data        Pointer to the buffer to copy the reply.         *
+*                 size        In size of data, out size of the reply in byte.  *
+*                 timeout_ms  Max time to wait in milli second, 0 for ever.    *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set, it is the handler errno if     *
+*                        the handler failed, ETIMEDOUT on timeout.             *
+\*----------------------------------------------------------------------------*/
+extern int shm_rpc_timedwait (struct shm_rpc *rpc, struct shm_rpc_call *call,
+                              void *data, unsigned int *size,
+                              unsigned int timeout_ms)
+{
+  struct rpc_hdr *hdr = rpc->base;
+  struct rpc_slot *slot;
+  struct timespec end, now, left;
+  unsigned int state = 0;
+  unsigned int spin = 0;
+  int logged = 0;
+  int err = 0;
+
+  if(call->slot >= hdr->slots ||
+     (slot = rpc_slot(hdr, call->slot))->id != call->id)
+  {
+    shm_log_event(SHM_EV_RPC_WAIT_CALL, EINVAL, rpc->key, (int)call->id);
+    errno = EINVAL;
+    return -1;
+  }
+
+  while((state = rpc_load(&slot->state)) != SLOT_REPLY && spin < SHM_RPC_SPIN)
+  {
+    cpu_relax();
+    spin++;
+  }
+
+  if(state != SLOT_REPLY)
+  {
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    end.tv_sec  += timeout_ms / 1000;
+    end.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if(end.tv_nsec >= 1000000000L)
+    {
+      end.tv_sec++;
+      end.tv_nsec -= 1000000000L;
+    }
+
+    /* Publish the waiter before checking the state a last time */
+    rpc_store(&slot->waiting, 1);
+
+    while((state = rpc_load(&slot->state)) != SLOT_REPLY)
+    {
+      if(timeout_ms != 0)
+      {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        left.tv_sec  = end.tv_sec - now.tv_sec;
+        left.tv_nsec = end.tv_nsec - now.tv_nsec;
+        if(left.tv_nsec < 0)
+        {
+          left.tv_sec--;
+          left.tv_nsec += 1000000000L;
+        }
+        if(left.tv_sec < 0)
+        {
+          errno = ETIMEDOUT;
+          return -1;
+        }
+      }
+
+      if(rpc_futex(&slot->state, FUTEX_WAIT, state,
+                   (timeout_ms != 0) ? &left : NULL) < 0 &&
+         errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT)
+      {
+        /* Never leave the slot behind, poll for the reply instead */
+        if(!logged)
+        {
+          shm_log_event(SHM_EV_RPC_WAIT_FUTEX, errno, rpc->key,
+                        (int)call->slot);
+          logged = 1;
+        }
+        sched_yield();
+      }
+    }
+  }
+
+  if((err = slot->status) == 0 && slot->size > *size)
+  {
+    err = EMSGSIZE;
+  }
+  else if(err == 0)
+  {
+    memcpy(data, slot->data, slot->size);
+  }
+  *size = slot->size;
+
+  rpc_store(&slot->state, SLOT_FREE);
+
+  if(err != 0)
+  {
+    errno = err;
+    return -1;
+  }
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_rpc_cancel                                               *
+* Description   : This function gives up a call, its reply is dropped and its  *
+*                 slot given back as soon as the server is done with it.       *
+* Argument      : rpc   Handle filled by shm_rpc_attach.                       *
+*                 call  Call filled by shm_rpc_submit.                         *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set.                                *
+\*----------------------------------------------------------------------------*/
+extern int shm_rpc_cancel (struct shm_rpc *rpc, struct shm_rpc_call *call)
+{
+  struct rpc_hdr *hdr = rpc->base;
+  struct rpc_slot *slot;
+  unsigned int state = SLOT_REQUEST;
+
+  if(call->slot >= hdr->slots ||
+     (slot = rpc_slot(hdr, call->slot))->id != call->id)
+  {
+    errno = EINVAL;
+    return -1;
+  }
+
+  /* Not taken by a worker yet */
+  if(rpc_cas(&slot->state, state, SLOT_FREE))
+  {
+    return 0;
+  }
+
+  /* Being served or served, the second of the worker and us frees it */
+  if(__atomic_exchange_n(&slot->orphan, ORPHAN_CLIENT, __ATOMIC_SEQ_CST) ==
+     ORPHAN_REPLY)
+  {
+    rpc_store(&slot->state, SLOT_FREE);
+  }
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_rpc_call                                                 *
+* Description   : This function does a complete round trip, submit then wait.  *
+* Argument      : rpc       Handle filled by shm_rpc_attach.                   *
+*                 req       Pointer to the request.                            *
+*                 size      Size of the request in byte.                       *
+*                 rep       Pointer to the buffer to copy the reply.           *
+*                 rep_size  In size of rep, out size of the reply in byte.     *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set.                                *
+\*----------------------------------------------------------------------------*/
+extern int shm_rpc_call (struct shm_rpc *rpc, void *req, unsigned int size,
+                         void *rep, unsigned int *rep_size)
+{
+  struct shm_rpc_call call;
+
+  if((shm_rpc_submit(rpc, req, size, &call)) < 0)
+  {
+    return -1;
+  }
+
+  return shm_rpc_wait(rpc, &call, rep, rep_size);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_rpc_serve                                                *
+* Description   : This function runs a pool of workers serving the requests   *
+*                 of a RPC segment. It returns when shm_rpc_stop is called.    *
+*                 The slots left by a dead server or by dead clients are       *
+*                 given back first.                                            *
+* Argument      : rpc      Handle filled by shm_rpc_attach.                    *
+*                 workers  Number of worker threads.                           *
+*                 handler  Called for each request, it writes the reply over   *
+*                          the request and returns its size, or -1 and errno.  *
+*                 arg      Passed as is to the handler.                        *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set, EBUSY if another server runs.  *
+\*----------------------------------------------------------------------------*/
+extern int shm_rpc_serve (struct shm_rpc *rpc, unsigned int workers,
+                          shm_rpc_handler handler, void *arg)
+{
+  struct rpc_hdr *hdr = rpc->base;
+  struct rpc_worker ctx[SHM_RPC_MAX_WORKS];
+  pthread_t tid[SHM_RPC_MAX_WORKS];
+  unsigned int i = 0;
+  int err = 0;
+
+  if(workers == 0 || workers > SHM_RPC_MAX_WORKS)
+  {
+    shm_log_event(SHM_EV_RPC_SERVE_WORKERS, EINVAL, rpc->key, (int)workers);
+    errno = EINVAL;
+    return -1;
+  }
+
+  /* Only one live server per segment */
+  if(rpc_load(&hdr->running) && !rpc_dead(hdr->server) &&
+     hdr->server != getpid())
+  {
+    errno = EBUSY;
+    return -1;
+  }
+
+  if((i = (unsigned int)rpc_reap(hdr, 1)) != 0)
+  {
+    shm_log_event(SHM_EV_RPC_SERVE_REAP, 0, rpc->key, (int)i);
+  }
+
+  hdr->server = getpid();
+  rpc_store(&hdr->running, 1);
+
+  for(i = 0; i < workers; i++)
+  {
+    ctx[i].rpc     = rpc;
+    ctx[i].handler = handler;
+    ctx[i].arg     = arg;
+    ctx[i].first   = i * hdr->slots / workers;
+
+    if((err = pthread_create(&tid[i], NULL, rpc_worker, &ctx[i])) != 0)
+    {
+      shm_log_event(SHM_EV_RPC_SERVE_THREAD, err, rpc->key, (int)i);
+      shm_rpc_stop(rpc);
+      break;
+    }
+  }
+
+  while(i > 0)
+  {
+    pthread_join(tid[--i], NULL);
+  }
+
+  if(err != 0)
+  {
+    errno = err;
+    return -1;
+  }
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : shm_rpc_stop                                                 *
+* Description   : This function asks the workers of a RPC segment to return.   *
+*                 It can be called from any process attached to the segment.   *
+*                 Requests not taken by a worker fail with ESHUTDOWN, new ones *
+*                 are refused.                                                 *
+* Argument      : rpc  Handle filled by shm_rpc_attach.                        *
+* Return code   : 0      On success.                                           *
+*                 -1     On error errno is set.                                *
+\*----------------------------------------------------------------------------*/
+extern int shm_rpc_stop (struct shm_rpc *rpc)
+{
+  struct rpc_hdr *hdr = rpc->base;
+  struct rpc_slot *slot;
+  unsigned int state = 0;
+  unsigned int i = 0;
+  int ret = 0;
+
+  rpc_store(&hdr->running, 0);
+  rpc_add(&hdr->doorbell, 1);
+
+  if((rpc_futex(&hdr->doorbell, FUTEX_WAKE, SHM_RPC_MAX_WORKS, NULL)) < 0)
+  {
+    shm_log_event(SHM_EV_RPC_STOP_FUTEX, errno, rpc->key, 0);
+    ret = -1;
+  }
+
+  /* Complete what no worker will serve, submit takes care of the requests
+     published after this pass */
+  for(i = 0; i < hdr->slots; i++)
+  {
+    slot  = rpc_slot(hdr, i);
+    state = SLOT_REQUEST;
+
+    if(rpc_load(&slot->state) == SLOT_REQUEST &&
+       rpc_cas(&slot->state, state, SLOT_BUSY))
+    {
+      slot->size = 0;
+      rpc_complete(slot, ESHUTDOWN);
+    }
+  }
+
+  return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : rpc_slot                                                     *
+* Description   : This function returns the address of a slot.                 *
+* Argument      : hdr  Mapped RPC segment.                                     *
+*                 i    Index of the slot.                                      *
+* Return code   : Pointer to the slot.                                         *
+\*----------------------------------------------------------------------------*/
+static struct rpc_slot *rpc_slot (struct rpc_hdr *hdr, unsigned int i)
+{
+  return (struct rpc_slot *)((char *)(hdr + 1) + (size_t)i * hdr->stride);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : rpc_futex                                                    *
+* Description   : This function waits on or wakes a futex shared between       *
+*                 processes.                                                   *
+* Argument      : addr  Address of the futex word.                             *
+*                 op    FUTEX_WAIT or FUTEX_WAKE.                              *
+*                 val   Expected value for a wait, number to wake for a wake.  *
+*                 timeout  Relative timeout of a wait, NULL for ever.          *
+* Return code   : >= 0   On success.                                           *
+*                 -1     On error errno is set.                                *
+\*----------------------------------------------------------------------------*/
+static int rpc_futex (unsigned int *addr, int op, unsigned int val,
+                      const struct timespec *timeout)
+{
+  return (int)syscall(SYS_futex, addr, op, val, timeout, NULL, 0);
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : rpc_complete                                                 *
+* Description   : This function hands a served slot back to its client. The    *
+*                 slot is freed at once if the client cancelled the call.      *
+* Argument      : slot    Slot in SLOT_BUSY state, size set to the reply size. *
+*                 status  0 or errno of the call.                              *
+* Return code   : None.                                                        *
+\*----------------------------------------------------------------------------*/
+static void rpc_complete (struct rpc_slot *slot, int status)
+{
+  slot->status = status;
+
+  rpc_store(&slot->state, SLOT_REPLY);
+
+  if(rpc_load(&slot->waiting) != 0)
+  {
+    rpc_futex(&slot->state, FUTEX_WAKE, 1, NULL);
+  }
+
+  /* Second of the client and the worker to get here frees the slot */
+  if(__atomic_exchange_n(&slot->orphan, ORPHAN_REPLY, __ATOMIC_SEQ_CST) ==
+     ORPHAN_CLIENT)
+  {
+    rpc_store(&slot->state, SLOT_FREE);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : rpc_reap                                                     *
+* Description   : This function gives back the calls of dead clients. With     *
+*                 busy set, no worker runs and the calls left in SLOT_BUSY by  *
+*                 a dead server fail with ECONNABORTED.                        *
+* Argument      : hdr   Mapped RPC segment.                                    *
+*                 busy  1 to also complete the SLOT_BUSY slots.                *
+* Return code   : Number of slots given back or completed.                     *
+\*----------------------------------------------------------------------------*/
+static int rpc_reap (struct rpc_hdr *hdr, int busy)
+{
+  struct rpc_slot *slot;
+  unsigned int state = 0;
+  unsigned int i = 0;
+  int count = 0;
+
+  for(i = 0; i < hdr->slots; i++)
+  {
+    slot  = rpc_slot(hdr, i);
+    state = rpc_load(&slot->state);
+
+    if(state == SLOT_BUSY && busy)
+    {
+      slot->size = 0;
+      rpc_complete(slot, ECONNABORTED);
+      count++;
+    }
+    /* A claimed slot may still hold the pid of its previous client */
+    else if((state == SLOT_REQUEST || state == SLOT_REPLY) &&
+            rpc_dead(slot->pid) && rpc_cas(&slot->state, state, SLOT_FREE))
+    {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : rpc_dead                                                     *
+* Description   : This function tells whether a process does not exist.        *
+* Argument      : pid  The process to check, 0 for none.                       *
+* Return code   : 1 if it is dead or 0 is given, 0 if it exists.               *
+\*----------------------------------------------------------------------------*/
+static int rpc_dead (int pid)
+{
+  return (pid <= 0 || (kill(pid, 0) < 0 && errno == ESRCH));
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : rpc_scan                                                     *
+* Description   : This function serves every pending request found in one     *
+*                 pass over the slots.                                         *
+* Argument      : w  Worker context.                                           *
+* Return code   : Number of requests served.                                   *
+\*----------------------------------------------------------------------------*/
+static int rpc_scan (struct rpc_worker *w)
+{
+  struct rpc_hdr *hdr = w->rpc->base;
+  struct rpc_slot *slot;
+  unsigned int i = 0;
+  unsigned int state = 0;
+  int served = 0;
+  int ret = 0;
+
+  for(i = 0; i < hdr->slots; i++)
+  {
+    slot  = rpc_slot(hdr, (w->first + i) % hdr->slots);
+    state = SLOT_REQUEST;
+
+    if(rpc_load(&slot->state) != SLOT_REQUEST ||
+       !rpc_cas(&slot->state, state, SLOT_BUSY))
+    {
+      continue;
+    }
+
+    errno = 0;
+    if((ret = w->handler(w->arg, slot->data, slot->size, hdr->slot_size)) < 0)
+    {
+      slot->size = 0;
+      rpc_complete(slot, (errno != 0) ? errno : EIO);
+    }
+    else if((unsigned int)ret > hdr->slot_size)
+    {
+      /* The reply overflowed the slot, never let the client copy it */
+      slot->size = 0;
+      rpc_complete(slot, EMSGSIZE);
+    }
+    else
+    {
+      slot->size = (unsigned int)ret;
+      rpc_complete(slot, 0);
+    }
+
+    served++;
+  }
+
+  return served;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : rpc_worker                                                   *
+* Description   : Body of a server thread. It polls the slots while requests  *
+*                 keep coming and parks on the doorbell once idle.             *
+* Argument      : ctx  Worker context.                                         *
+* Return code   : NULL                                                         *
+\*----------------------------------------------------------------------------*/
+static void *rpc_worker (void *ctx)
+{
+  struct rpc_worker *w = ctx;
+  struct rpc_hdr *hdr = w->rpc->base;
+  unsigned int idle = 0;
+  unsigned int bell = 0;
+
+  while(rpc_load(&hdr->running))
+  {
+    if(rpc_scan(w) > 0)
+    {
+      idle = 0;
+      continue;
+    }
+
+    if(++idle < SHM_RPC_SPIN)
+    {
+      cpu_relax();
+      continue;
+    }
+
+    /* Announce the sleep then scan again, a submit that missed the
+       sleepers count is then either seen here or changes the doorbell */
+    bell = rpc_load(&hdr->doorbell);
+    rpc_add(&hdr->sleepers, 1);
+
+    if(rpc_scan(w) == 0 && rpc_load(&hdr->running))
+    {
+      rpc_futex(&hdr->doorbell, FUTEX_WAIT, bell, NULL);
+    }
+
+    rpc_add(&hdr->sleepers, -1);
+    idle = 0;
+  }
+
+#ifdef DEBUG
+  shm_log_event(SHM_EV_DBG_RPC_STOPPED, 0, w->rpc->key, (int)w->first);
+#endif
+
+  return NULL;
+}
+
+/*---------------------------------------------- Doxygen documentation sectin */
+/*!
+ *  \file shm_rpc.c
+ *  \brief Request/response calls over a shared memory
+ *  \author Renaud De Koninck
+ *  \version 1.0
+ *  \date 19 October 2026
+ */
+
+
+
+
+/*!
+ *  \fn int shm_rpc_creat (key_t key, unsigned int slots, unsigned int slot_size)
+ *  This function creates a shared memory holding the RPC slots. A client puts
+ *  its request in a free slot, a server worker writes the reply in the same
+ *  slot and the client waits on the completion of that slot. Like shm_creat it
+ *  can be called by several processes, a RPC segment that already exists with
+ *  the same geometry is kept with its calls in flight.
+ *  \param key       The key that will be used to create the segment.
+ *  \param slots     Number of calls that can be outstanding at the same time.
+ *  \param slot_size Max size of a request or a reply in byte.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error, EEXIST if the key is
+ *	  used by something else than a RPC segment, EINVAL if the existing
+ *	  segment has another geometry.
+ */
+
+/*!
+ *  \fn int shm_rpc_destroy (key_t key)
+ *  This function destroys a RPC shared memory.
+ *  \param key The key of the RPC segment to destroy.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error.
+ */
+
+/*!
+ *  \fn int shm_rpc_attach (struct shm_rpc *rpc, key_t key)
+ *  This function maps a RPC segment to the current process. Unlike shm_read
+ *  and shm_write the mapping is kept until shm_rpc_detach.
+ *  \param rpc Handle to fill.
+ *  \param key The key of the RPC segment.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error.
+ */
+
+/*!
+ *  \fn int shm_rpc_detach (struct shm_rpc *rpc)
+ *  This function unmaps a RPC segment from the current process.
+ *  \param rpc Handle filled by shm_rpc_attach.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error.
+ */
+
+/*!
+ *  \fn int shm_rpc_submit (struct shm_rpc *rpc, void *data, unsigned int size, struct shm_rpc_call *call)
+ *  This function copies a request in a free slot and wakes a worker if none
+ *  is polling. It does not wait for the reply.
+ *  \warning Every submitted call must be completed with shm_rpc_wait or
+ *  shm_rpc_cancel, the slot is not given back otherwise. The slots of dead
+ *  clients are only given back once all the slots are used.
+ *  \param rpc  Handle filled by shm_rpc_attach.
+ *  \param data Pointer to the request.
+ *  \param size Size of the request in byte.
+ *  \param call Filled with the slot and the correlation id of the call.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error, EAGAIN if all the slots
+ *	  are in use, ESHUTDOWN if no server runs shm_rpc_serve.
+ */
+
+/*!
+ *  \fn int shm_rpc_poll (struct shm_rpc *rpc, struct shm_rpc_call *call)
+ *  This function checks without blocking if the reply of a call is ready.
+ *  \param rpc  Handle filled by shm_rpc_attach.
+ *  \param call Call filled by shm_rpc_submit.
+ *  \return
+ *	- 0 If the reply is not ready.
+ *	- 1 If the reply is ready.
+ *	- -1 On Faillure & errno contains system error.
+ */
+
+/*!
+ *  \fn int shm_rpc_wait (struct shm_rpc *rpc, struct shm_rpc_call *call, void *data, unsigned int *size)
+ *  This function waits for the reply of a call, copies it and gives the slot
+ *  back. The slot is polled first, the caller parks on a futex only if the
+ *  reply takes long.
+ *  \param rpc  Handle filled by shm_rpc_attach.
+ *  \param call Call filled by shm_rpc_submit.
+ *  \param data Pointer to the buffer that will contains the reply.
+ *  \param size In the size of data, out the size of the reply in byte.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error or the errno set by the
+ *	  handler, EMSGSIZE if the reply does not fit in data, ESHUTDOWN if the
+ *	  server stopped before serving it, ECONNABORTED if it died serving it.
+ */
+
+/*!
+ *  \fn int shm_rpc_timedwait (struct shm_rpc *rpc, struct shm_rpc_call *call, void *data, unsigned int *size, unsigned int timeout_ms)
+ *  This function is shm_rpc_wait with a timeout. On timeout the call is still
+ *  outstanding, wait for it again or give it up with shm_rpc_cancel.
+ *  \param rpc        Handle filled by shm_rpc_attach.
+ *  \param call       Call filled by shm_rpc_submit.
+ *  \param data       Pointer to the buffer that will contains the reply.
+ *  \param size       In the size of data, out the size of the reply in byte.
+ *  \param timeout_ms Max time to wait in milli second, 0 to wait for ever.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno is set as by shm_rpc_wait, ETIMEDOUT on
+ *	  timeout.
+ */
+
+/*!
+ *  \fn int shm_rpc_cancel (struct shm_rpc *rpc, struct shm_rpc_call *call)
+ *  This function gives up a call. A request not taken by a worker yet is
+ *  dropped, otherwise the reply is dropped and the slot given back as soon as
+ *  the handler returns. The call must not be waited for afterwards.
+ *  \param rpc  Handle filled by shm_rpc_attach.
+ *  \param call Call filled by shm_rpc_submit.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error.
+ */
+
+/*!
+ *  \fn int shm_rpc_call (struct shm_rpc *rpc, void *req, unsigned int size, void *rep, unsigned int *rep_size)
+ *  This function does a complete round trip, shm_rpc_submit then
+ *  shm_rpc_wait.
+ *  \param rpc      Handle filled by shm_rpc_attach.
+ *  \param req      Pointer to the request.
+ *  \param size     Size of the request in byte.
+ *  \param rep      Pointer to the buffer that will contains the reply.
+ *  \param rep_size In the size of rep, out the size of the reply in byte.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error.
+ */
+
+/*!
+ *  \fn int shm_rpc_serve (struct shm_rpc *rpc, unsigned int workers, shm_rpc_handler handler, void *arg)
+ *  This function runs a pool of worker threads serving the requests of a RPC
+ *  segment and returns when shm_rpc_stop is called. The handler receives the
+ *  request in a buffer of max byte, writes the reply over it and returns the
+ *  size of the reply, or -1 with errno set. Only one process serves a segment
+ *  at a time. The calls a dead server was running fail with ECONNABORTED and
+ *  the slots of dead clients are given back when the next server starts.
+ *  \param rpc     Handle filled by shm_rpc_attach.
+ *  \param workers Number of worker threads.
+ *  \param handler Function called for each request.
+ *  \param arg     Passed as is to the handler.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error, EBUSY if another live
+ *	  process serves the segment.
+ */
+
+/*!
+ *  \fn int shm_rpc_stop (struct shm_rpc *rpc)
+ *  This function asks the workers of a RPC segment to return. It can be
+ *  called from any process attached to the segment. The requests not taken
+ *  by a worker are completed with ESHUTDOWN and new ones are refused until
+ *  shm_rpc_serve runs again.
+ *  \param rpc Handle filled by shm_rpc_attach.
+ *  \return
+ *	- 0 On success.
+ *	- -1 On Faillure & errno contains system error.
+ */
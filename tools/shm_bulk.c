@@ -0,0 +1,152 @@
+/* This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*---------------------------------------------------------- Standard Headers */
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------- Project Headers */
+
+#include "shm_manifest.h"
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------- Defines */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------ Data structure */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------- Functions prototype */
+
+static void usage (const char *name);
+
+/*----------------------------------------------------------------------------*/
+/*--------------------------------------------------------------- Global data */
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------- Functions */
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : main                                                         *
+* Description   : Creates and pre-faults (up) or destroys (down) all the       *
+*                 segments and queues of a manifest.                           *
+*                 shm_bulk [-j threads] [-q] up|down <manifest>                *
+\*----------------------------------------------------------------------------*/
+int main (int argc, char *argv[])
+{
+  struct shm_manifest man;
+  struct shm_man_entry *e;
+  struct timespec t0, t1;
+  unsigned int threads = 0;
+  unsigned int failed = 0;
+  unsigned int i = 0;
+  int quiet = 0;
+  int up = 0;
+  int opt = 0;
+  int ret = 0;
+
+  while((opt = getopt(argc, argv, "j:q")) != -1)
+  {
+    switch(opt)
+    {
+      case 'j': threads = (unsigned int)atoi(optarg); break;
+      case 'q': quiet = 1;                            break;
+      default : usage(argv[0]);                       return 1;
+    }
+  }
+
+  if(optind + 2 != argc)
+  {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if(strcmp(argv[optind], "up") == 0)
+  {
+    up = 1;
+  }
+  else if(strcmp(argv[optind], "down") != 0)
+  {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if((shm_manifest_load(&man, argv[optind + 1])) < 0)
+  {
+    if(man.line != 0)
+    {
+      fprintf(stderr, "%s:%u: invalid line\n", argv[optind + 1], man.line);
+    }
+    else
+    {
+      fprintf(stderr, "Can not load %s: %s\n", argv[optind + 1],
+                                                              strerror(errno));
+    }
+    return 1;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  ret = up ? shm_manifest_creat(&man, threads)
+           : shm_manifest_destroy(&man, threads);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  for(i = 0; i < man.count; i++)
+  {
+    e = &man.entry[i];
+
+    if(e->status != 0)
+    {
+      failed++;
+    }
+    if(quiet && e->status == 0)
+    {
+      continue;
+    }
+
+    printf("%4d %s 0x%08X %-*s %s\n", e->line,
+           (e->kind == SHM_MAN_SHM) ? "shm" : "ipc", (unsigned int)e->key,
+           SHM_MAN_NAME, e->name,
+           (e->status != 0) ? strerror(e->status) :
+           !up ? "destroyed" : e->created ? "created" : "exists");
+  }
+
+  printf("%s: %u entries, %u failed, %.3f ms\n", argv[optind], man.count,
+         failed, (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
+
+  shm_manifest_free(&man);
+
+  return (ret < 0) ? 1 : 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : usage                                                        *
+* Description   : This function prints the command line help.                 *
+* Argument      : name  Name of the program.                                   *
+* Return code   : None.                                                        *
+\*----------------------------------------------------------------------------*/
+static void usage (const char *name)
+{
+  fprintf(stderr, "Usage: %s [-j threads] [-q] up|down <manifest>\n", name);
+  fprintf(stderr, "  up    create or check and pre-fault every entry\n");
+  fprintf(stderr, "  down  destroy every entry\n");
+  fprintf(stderr, "  -j    number of threads, one per CPU by default\n");
+  fprintf(stderr, "  -q    only print the failed entries\n");
+}
@@ -0,0 +1,299 @@
+/* This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+/*---------------------------------------------------------- Standard Headers */
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------- Project Headers */
+
+#include "shm_log.h"
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------------- Defines */
+
+#define TAIL_PERIOD_US 100000  /* Poll period of the follow mode              */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------------ Data structure */
+
+/*----------------------------------------------------------------------------*/
+/*------------------------------------------------------- Functions prototype */
+
+static double tail_tsc_hz (struct shm_log_hdr *hdr);
+static void   tail_print  (struct shm_log_hdr *hdr, struct shm_log_rec *rec,
+                           double hz);
+static void   usage       (const char *name);
+static void   tail_stop   (int sig);
+
+/*----------------------------------------------------------------------------*/
+/*--------------------------------------------------------------- Global data */
+
+static volatile sig_atomic_t tail_stopped = 0;
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------- Functions */
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : main                                                         *
+* Description   : Decodes the event ring of a process, shm_log_tail <pid> or   *
+*                 shm_log_tail -k <key>. With -f new events are printed as     *
+*                 they come until SIGINT or SIGTERM, with -r the ring is       *
+*                 destroyed once printed.                                      *
+*                 shm_log_tail -s destroys the rings of the dead processes.    *
+\*----------------------------------------------------------------------------*/
+int main (int argc, char *argv[])
+{
+  struct shm_log_hdr *hdr;
+  struct shm_log_rec *ring;
+  struct shm_log_rec rec;
+  struct shmid_ds ds;
+  unsigned long long tail = 0;
+  unsigned long long head = 0;
+  unsigned long long seq = 0;
+  unsigned long long lost = 0;
+  double hz = 0;
+  key_t key = 0;
+  int follow = 0;
+  int remove = 0;
+  int sweep = 0;
+  int shmid = 0;
+  int opt = 0;
+
+  while((opt = getopt(argc, argv, "fk:rs")) != -1)
+  {
+    switch(opt)
+    {
+      case 'f': follow = 1;                             break;
+      case 'k': key = (key_t)strtoul(optarg, NULL, 0);  break;
+      case 'r': remove = 1;                             break;
+      case 's': sweep = 1;                              break;
+      default : usage(argv[0]);                         return 1;
+    }
+  }
+
+  if(sweep)
+  {
+    if((shmid = shm_log_sweep()) < 0)
+    {
+      fprintf(stderr, "Can not list shared memories: %s\n", strerror(errno));
+      return 1;
+    }
+    printf("%d event rings destroyed\n", shmid);
+    return 0;
+  }
+
+  if(key == 0 && optind < argc)
+  {
+    key = SHM_LOG_KEY(atoi(argv[optind]));
+  }
+  if(key == 0)
+  {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if((shmid = shmget(key, 0, 0)) < 0 ||
+     (hdr = shmat(shmid, NULL, SHM_RDONLY)) == (void *)-1)
+  {
+    fprintf(stderr, "No event ring 0x%08X: %s\n", (unsigned int)key,
+                                                              strerror(errno));
+    return 1;
+  }
+
+  /* records drives every index, never trust it alone */
+  if(shmctl(shmid, IPC_STAT, &ds) < 0 ||
+     ds.shm_segsz < sizeof(struct shm_log_hdr) ||
+     hdr->magic != SHM_LOG_MAGIC || hdr->records == 0 ||
+     (hdr->records & (hdr->records - 1)) != 0 ||
+     ds.shm_segsz != sizeof(struct shm_log_hdr) +
+                     hdr->records * sizeof(struct shm_log_rec))
+  {
+    fprintf(stderr, "Shared memory 0x%08X is not an event ring\n",
+                                                            (unsigned int)key);
+    shmdt(hdr);
+    return 1;
+  }
+
+  /* Leave the follow loop cleanly so that -r still applies */
+  signal(SIGINT, tail_stop);
+  signal(SIGTERM, tail_stop);
+
+  ring = (struct shm_log_rec *)(hdr + 1);
+  hz   = tail_tsc_hz(hdr);
+  head = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+  tail = (head > hdr->records) ? head - hdr->records : 0;
+
+  do
+  {
+    head = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+
+    if(head - tail > hdr->records)
+    {
+      lost += head - tail - hdr->records;
+      tail  = head - hdr->records;
+    }
+
+    for(; tail < head; tail++)
+    {
+      struct shm_log_rec *slot = &ring[tail & (hdr->records - 1)];
+
+      /* Not yet complete, try again on the next period */
+      if((seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE)) < tail + 1)
+      {
+        break;
+      }
+
+      memcpy(&rec, slot, sizeof(rec));
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+      /* Overwritten by the writer while copied */
+      if(seq != tail + 1 || __atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq)
+      {
+        lost++;
+        continue;
+      }
+
+      tail_print(hdr, &rec, hz);
+    }
+
+    if(lost != 0)
+    {
+      printf("-- %llu events lost\n", lost);
+      lost = 0;
+    }
+
+    if(follow)
+    {
+      fflush(stdout);
+      usleep(TAIL_PERIOD_US);
+    }
+  } while(follow && !tail_stopped);
+
+  shmdt(hdr);
+
+  if(remove && shmctl(shmid, IPC_RMID, 0) < 0)
+  {
+    fprintf(stderr, "Can not destroy event ring: %s\n", strerror(errno));
+    return 1;
+  }
+
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : tail_tsc_hz                                                  *
+* Description   : This function measures the time stamp counter frequency, in  *
+*                 tick per nanosecond, against the realtime clock.             *
+* Argument      : hdr  Ring header.                                            *
+* Return code   : Tick per nanosecond.                                         *
+\*----------------------------------------------------------------------------*/
+static double tail_tsc_hz (struct shm_log_hdr *hdr)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  struct timespec t0, t1;
+  unsigned long long c0 = 0;
+  unsigned long long c1 = 0;
+
+  if(hdr->tsc_ns)
+  {
+    return 1.0;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  c0 = __rdtsc();
+  usleep(20000);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  c1 = __rdtsc();
+
+  return (double)(c1 - c0) / ((t1.tv_sec - t0.tv_sec) * 1e9 +
+                              (t1.tv_nsec - t0.tv_nsec));
+#else
+  (void)hdr;
+  return 1.0;
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : tail_print                                                   *
+* Description   : This function prints one record on a line.                  *
+* Argument      : hdr  Ring header.                                            *
+*                 rec  Record to print.                                        *
+*                 hz   Tick per nanosecond.                                    *
+* Return code   : None.                                                        *
+\*----------------------------------------------------------------------------*/
+static void tail_print (struct shm_log_hdr *hdr, struct shm_log_rec *rec,
+                        double hz)
+{
+  unsigned long long ns = 0;
+  struct tm tm;
+  time_t sec;
+  char date[32];
+
+  ns  = hdr->ns0 + (unsigned long long)((double)(rec->tsc - hdr->tsc0) / hz);
+  sec = (time_t)(ns / 1000000000ULL);
+  localtime_r(&sec, &tm);
+  strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &tm);
+
+  printf("%s.%09llu %5d %-20s key 0x%08X arg %-6d errno %d (%s)\n",
+         date, ns % 1000000000ULL, hdr->pid, shm_log_event_name(rec->event),
+         (unsigned int)rec->key, rec->arg, rec->err,
+         (rec->err != 0) ? strerror(rec->err) : "-");
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : usage                                                        *
+* Description   : This function prints the command line help.                 *
+* Argument      : name  Name of the program.                                   *
+* Return code   : None.                                                        *
+\*----------------------------------------------------------------------------*/
+static void usage (const char *name)
+{
+  fprintf(stderr, "Usage: %s [-f] [-r] <pid> | -k <key>\n", name);
+  fprintf(stderr, "       %s -s\n", name);
+  fprintf(stderr, "  -f  follow, print new events as they come until ^C\n");
+  fprintf(stderr, "  -r  destroy the ring once printed\n");
+  fprintf(stderr, "  -s  destroy the rings of the dead processes\n");
+}
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*\
+* Creation Date : 19-10-2026                                                   *
+* Name          : tail_stop                                                    *
+* Description   : Signal handler, it ends the follow mode.                     *
+* Argument      : sig  Signal received.                                        *
+* Return code   : None.                                                        *
+\*----------------------------------------------------------------------------*/
+static void tail_stop (int sig)
+{
+  (void)sig;
+  tail_stopped = 1;
+}